@@ -0,0 +1,213 @@
+#include "shop.h"
+
+#include <random>
+
+// Перевірка продуктивності магазину проти збережених базових показників (запускається через ctest)
+// Запуск: Indiv_OOP_perf --data=data.txt --baseline=perf_baseline.txt [--repeat=5] [--dir=.]
+//         Indiv_OOP_perf --data=data.txt --update-baseline=perf_baseline.txt [--repeat=5] [--dir=.]
+// Набір даних створює Indiv_OOP_datagen (у ctest - окремим тестом-підготовкою на 1M замовлень)
+// Сценарії: завантаження набору, відправка 100k замовлень, збереження знімка завантаженого магазину
+// Регресія - медіана повторів повільніша за базову більше ніж на допуск і водночас на кілька
+// розкидів (MAD), тож шум окремих запусків не валить перевірку
+// Неоптимізована збірка пропускається (код 77), бо базові показники зняті з оптимізацією
+
+static constexpr int skippedExitCode = 77;
+static constexpr double madScale = 1.4826;     // MAD -> стандартне відхилення для нормального розподілу
+static constexpr double significantSigmas = 3; // Скільки розкидів має бути між медіанами
+
+struct PerfConfig {
+    string data;
+    string baseline;
+    string updateBaseline;
+    string dir = ".";
+    size_t repeat = 5;
+    size_t shipOrders = 100000;
+    double tolerance = 0.25; // Для сценаріїв, нових у базовому файлі
+};
+
+// Медіана і MAD повторів одного сценарію, мс
+struct ScenarioResult {
+    string name;
+    double median = 0;
+    double mad = 0;
+};
+
+struct BaselineEntry {
+    double median = 0;
+    double mad = 0;
+    double tolerance = 0;
+};
+
+static double median(vector<double> values) {
+    sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+static ScenarioResult summarize(const string &name, const vector<double> &milliseconds) {
+    double center = median(milliseconds);
+    vector<double> deviations;
+    for (double value: milliseconds) deviations.push_back(abs(value - center));
+    return {name, center, median(deviations)};
+}
+
+template<typename F>
+static double timeMilliseconds(F action) {
+    auto start = chrono::steady_clock::now();
+    action();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Формат: рядки "сценарій медіана_мс mad_мс допуск"; # - коментар
+static map<string, BaselineEntry> readBaseline(const string &file) {
+    ifstream input(file);
+    if (!input) throw runtime_error("Failed to open baseline file: " + file);
+    map<string, BaselineEntry> baseline;
+    string line;
+    while (getline(input, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        string name;
+        BaselineEntry entry;
+        if (!(fields >> name >> entry.median >> entry.mad >> entry.tolerance)) {
+            throw runtime_error("Malformed baseline line: " + line);
+        }
+        baseline[name] = entry;
+    }
+    return baseline;
+}
+
+static void writeBaseline(const string &file, const vector<ScenarioResult> &results,
+                          const map<string, BaselineEntry> &previous, double tolerance) {
+    ofstream output(file);
+    if (!output) throw runtime_error("Failed to open file for writing.");
+    output << "# Базові показники Indiv_OOP_perf: сценарій, медіана (мс), MAD (мс), допустиме сповільнення\n"
+              "# Знято з оптимізованої збірки; оновлення - Indiv_OOP_perf --update-baseline=<цей файл>\n";
+    for (const auto &result: results) {
+        auto it = previous.find(result.name);
+        output << result.name << ' ' << result.median << ' ' << result.mad << ' '
+               << (it != previous.end() ? it->second.tolerance : tolerance) << '\n';
+    }
+    if (!output) throw runtime_error("Failed to write baseline file.");
+}
+
+// Магазин з bikes моделями, запасу яких вистачає на будь-яку кількість відправок
+static void stockShop(Shop &shop, size_t bikes) {
+    for (size_t i = 0; i < bikes; ++i) {
+        string model = "Perf-" + to_string(i);
+        if (i % 2) {
+            RoadBike bike(model, 54, 28, 22, 1000 + static_cast<double>(i % 5000),
+                          static_cast<AerodynamicsLevel>(1 + i % 3));
+            shop.addBike(&bike, 1 << 30);
+        } else {
+            MountainBike bike(model, 18, 29, 12, 800 + static_cast<double>(i % 3000), "Fox",
+                              i % 4 ? SuspensionType::Hardtail : SuspensionType::Full);
+            shop.addBike(&bike, 1 << 30);
+        }
+    }
+}
+
+static vector<ScenarioResult> runScenarios(const PerfConfig &config) {
+    vector<double> load, ship, save;
+    string snapshot = config.dir + "/perf_snapshot.txt";
+    for (size_t r = 0; r < config.repeat; ++r) {
+        {
+            Shop shop;
+            load.push_back(timeMilliseconds([&] { shop.loadFromfile(config.data); }));
+            save.push_back(timeMilliseconds([&] { shop.saveAllDataToFile(snapshot); }));
+        }
+
+        // Замовлення готуються заздалегідь; вимірюється лише відправка
+        constexpr size_t bikes = 10000;
+        Shop shop;
+        stockShop(shop, bikes);
+        mt19937_64 rng(r + 1);
+        vector<unique_ptr<Order>> pending;
+        pending.reserve(config.shipOrders);
+        for (size_t i = 0; i < config.shipOrders; ++i) {
+            vector<OrderItem> items;
+            size_t lines = 1 + rng() % 4;
+            for (size_t line = 0; line < lines; ++line) {
+                items.emplace_back(shop.findBikeByModel("Perf-" + to_string(rng() % bikes)),
+                                   1 + static_cast<int>(rng() % 3));
+            }
+            string user = "customer" + to_string(rng() % 20000);
+            if (i % 3 == 0) pending.push_back(make_unique<FixedDiscountOrder>(user, std::move(items), 10));
+            else if (i % 3 == 1) pending.push_back(make_unique<ProgressiveDiscountOrder>(user, std::move(items)));
+            else pending.push_back(make_unique<Order>(user, std::move(items)));
+        }
+        ship.push_back(timeMilliseconds([&] {
+            for (auto &order: pending) shop.shipOrder(std::move(order));
+        }));
+    }
+    remove(snapshot.c_str());
+    return {summarize("load_dataset", load), summarize("ship_100k_orders", ship),
+            summarize("save_snapshot", save)};
+}
+
+int main(int argc, char **argv) {
+    PerfConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            auto value = [&](const string &key) { return arg.substr(key.size()); };
+            if (arg.rfind("--data=", 0) == 0) config.data = value("--data=");
+            else if (arg.rfind("--baseline=", 0) == 0) config.baseline = value("--baseline=");
+            else if (arg.rfind("--update-baseline=", 0) == 0) config.updateBaseline = value("--update-baseline=");
+            else if (arg.rfind("--dir=", 0) == 0) config.dir = value("--dir=");
+            else if (arg.rfind("--repeat=", 0) == 0) config.repeat = max<size_t>(3, stoul(value("--repeat=")));
+            else if (arg.rfind("--tolerance=", 0) == 0) config.tolerance = stod(value("--tolerance="));
+            else throw invalid_argument("Unknown argument: " + arg);
+        }
+        if (config.data.empty()) throw invalid_argument("Perf gate needs --data.");
+        if (config.baseline.empty() == config.updateBaseline.empty()) {
+            throw invalid_argument("Use exactly one of --baseline and --update-baseline.");
+        }
+#if !defined(__OPTIMIZE__) && !(defined(_MSC_VER) && !defined(_DEBUG))
+        cerr << "Skipped: perf gate needs an optimized build (e.g. -DCMAKE_BUILD_TYPE=Release)." << endl;
+        return skippedExitCode;
+#endif
+
+        // Повідомлення магазину не виводяться, щоб не вимірювати консоль
+        cout.setstate(ios::failbit);
+        auto results = runScenarios(config);
+
+        if (!config.updateBaseline.empty()) {
+            map<string, BaselineEntry> previous;
+            if (ifstream(config.updateBaseline)) previous = readBaseline(config.updateBaseline);
+            writeBaseline(config.updateBaseline, results, previous, config.tolerance);
+            for (const auto &result: results) {
+                cerr << result.name << ": median " << result.median << " ms, MAD " << result.mad << " ms" << endl;
+            }
+            return 0;
+        }
+
+        auto baseline = readBaseline(config.baseline);
+        bool regressed = false;
+        for (const auto &result: results) {
+            auto it = baseline.find(result.name);
+            if (it == baseline.end()) {
+                cerr << result.name << ": median " << result.median << " ms, no baseline" << endl;
+                continue;
+            }
+            const BaselineEntry &base = it->second;
+            double noise = madScale * max(result.mad, base.mad);
+            bool slower = result.median > base.median * (1 + base.tolerance);
+            bool significant = result.median - base.median > significantSigmas * noise;
+            double change = (result.median / base.median - 1) * 100;
+            cerr << result.name << ": median " << result.median << " ms (MAD " << result.mad << "), baseline "
+                 << base.median << " ms, " << (change >= 0 ? "+" : "") << change << "%";
+            if (slower && significant) {
+                regressed = true;
+                cerr << " REGRESSION (limit +" << base.tolerance * 100 << "%)";
+            } else if (result.median < base.median * (1 - base.tolerance)) {
+                cerr << " faster than baseline, consider --update-baseline";
+            }
+            cerr << endl;
+        }
+        return regressed ? 1 : 0;
+    } catch (exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
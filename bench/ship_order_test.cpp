@@ -0,0 +1,63 @@
+#define SHOP_ALLOCATION_HOOKS // Лічильники виділень пам'яті для перевірки shipOrder
+
+#include "shop.h"
+
+// Перевірка (ctest): shipOrder переносить рядки замовлення в історію без жодної копії вектора рядків
+// Два однакові магазини відправляють замовлення на 1 і на 256 рядків; копія вектора рядків великого
+// замовлення виділила б щонайменше 255 * sizeof(OrderItem) байт понад малий
+// Також перевіряється, що історія переживає видалення велосипеда з інвентаря
+
+static constexpr int lines = 256;
+static constexpr int warmupOrders = 8;
+
+static unique_ptr<Shop> makeShop() {
+    auto shop = make_unique<Shop>();
+    RoadBike bike("Alloc-Road", 54, 28, 22, 1200, AerodynamicsLevel::Standard);
+    shop->addBike(&bike, 100000);
+    // Прогрів: аналітика і клієнт уже мають записи, тож відправка не створює нових вузлів
+    for (int i = 0; i < warmupOrders; ++i) {
+        shop->shipOrder(make_unique<Order>("alloc", vector<OrderItem>{OrderItem(shop->findBikeByModel("Alloc-Road"))}));
+    }
+    return shop;
+}
+
+static unique_ptr<Order> makeOrder(Shop &shop, int count) {
+    vector<OrderItem> items;
+    items.reserve(count);
+    for (int i = 0; i < count; ++i) items.emplace_back(shop.findBikeByModel("Alloc-Road"), 1);
+    return make_unique<Order>("alloc", std::move(items));
+}
+
+int main() {
+    try {
+        AllocationTracker::enable();
+        auto small = makeShop();
+        auto large = makeShop();
+        auto smallOrder = makeOrder(*small, 1);
+        auto largeOrder = makeOrder(*large, lines);
+
+        auto baseline = AllocationTracker::measure([&] { small->shipOrder(std::move(smallOrder)); });
+        uint64_t vectorCopy = sizeof(OrderItem) * (lines - 1);
+        AllocationTracker::require([&] { large->shipOrder(std::move(largeOrder)); },
+                                   baseline.allocations, baseline.bytes + vectorCopy - 1);
+        cout << "shipOrder: " << baseline.allocations << " allocations, " << baseline.bytes << " bytes for 1 and "
+             << lines << " lines" << endl;
+
+        // Рядки історії утримують велосипед після видалення з інвентаря
+        large->removeBike("Alloc-Road");
+        const Order *shipped = large->pageOrders(warmupOrders, 1).items.front();
+        if (shipped->getItems().front().getBike()->getModel() != "Alloc-Road") {
+            throw runtime_error("Order history lost its bike after removeBike.");
+        }
+        // Усі рядки історії спільно утримують один велосипед - він враховується один раз
+        if (large->memoryUsage().bikes != sizeof(RoadBike)) {
+            throw runtime_error("Memory usage counts a shared history bike more than once.");
+        }
+        large->saveAllDataToFile("ship_order_test.txt");
+        remove("ship_order_test.txt");
+    } catch (exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
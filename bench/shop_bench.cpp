@@ -0,0 +1,536 @@
+#define SHOP_ALLOCATION_HOOKS // Лічильники виділень пам'яті для всього процесу і для кожної операції
+#include "shop.h"
+
+#include <random>
+
+// Бенчмарки основних операцій магазину
+// Запуск: Indiv_OOP_bench [--sizes=1000,10000,100000] [--ops=1000] [--repeat=3] [--dir=.]
+//         Indiv_OOP_bench --data=data.txt [--trace=trace.txt] [--repeat=3] [--dir=.]
+// З --latency останнім рядком виводяться гістограми затримок усіх операцій магазину за весь запуск;
+// --latency-sample=N вимірює тривалість лише кожного N-го виклику (інтервал виводиться поруч із гістограмами)
+// З --allocations виводяться виділення пам'яті на виклик кожної операції магазину (разом із вкладеними)
+// З --chrome-trace=file.json фази операцій записуються у трасу Chrome (останні події кожного потоку)
+// З --memory замість вимірів часу виводиться пам'ять магазину (байти на SKU і на замовлення)
+// для відправлених у процесі і завантажених з файлу замовлень
+// З --readers=N замість вимірів часу N потоків читають знімки інвентарю, поки основний потік
+// відправляє замовлення і змінює ціни; виводиться пропускна здатність читачів і письменника
+// Другий режим вимірює завантаження готового набору даних і відтворення траси операцій
+// (обидва файли створює Indiv_OOP_datagen)
+// Кожен рядок виводу - окремий JSON-об'єкт (JSON Lines) у стабільному порядку, тож результати
+// двох версій можна порівнювати звичайним diff
+
+struct BenchConfig {
+    vector<size_t> sizes{1000, 10000, 100000};
+    size_t ops = 1000;
+    size_t repeat = 3;
+    string dir = ".";
+    string data;  // Набір даних для режиму відтворення
+    string trace; // Траса операцій для режиму відтворення
+    bool latency = false;
+    bool allocations = false;
+    string chromeTrace; // Файл траси Chrome
+    bool memory = false;
+    size_t snapshotReaders = 0; // Потоки читачів знімків; 0 - звичайні виміри
+};
+
+// Результат одного виміру: час і виділення пам'яті на всю партію операцій
+struct Sample {
+    double nanoseconds = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+// Вимір партії операцій; action отримує номер операції
+template<typename F>
+Sample measure(size_t ops, F action) {
+    auto before = AllocationTracker::processTotals();
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < ops; ++i) {
+        action(i);
+    }
+    auto finish = chrono::steady_clock::now();
+    auto used = AllocationTracker::processTotals() - before;
+    return {chrono::duration<double, nano>(finish - start).count(), used.allocations, used.bytes};
+}
+
+class BenchReport {
+    FileSink sink{stdout};
+    ReportWriter out{sink};
+
+public:
+    // Медіана повторів за часом; виділення пам'яті беруться з того самого повтору
+    void add(const string &name, size_t size, size_t ops, vector<Sample> samples) {
+        sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b) {
+            return a.nanoseconds < b.nanoseconds;
+        });
+        const Sample &median = samples[samples.size() / 2];
+        double perOp = median.nanoseconds / static_cast<double>(ops);
+        out << "{\"benchmark\":";
+        out.json(name) << ",\"size\":" << size << ",\"ops\":" << ops << ",\"repeat\":" << samples.size()
+                       << ",\"ns_per_op\":" << perOp << ",\"ops_per_sec\":" << (perOp > 0 ? 1e9 / perOp : 0.0)
+                       << ",\"allocs_per_op\":" << static_cast<double>(median.allocations) / static_cast<double>(ops)
+                       << ",\"bytes_per_op\":" << static_cast<double>(median.bytes) / static_cast<double>(ops)
+                       << "}\n";
+        out.flush();
+    }
+
+    // Пропускна здатність читачів знімків під час змін магазину
+    void addReaders(size_t size, size_t readers, uint64_t reads, uint64_t writes, double seconds) {
+        out << "{\"benchmark\":\"snapshotReaders\",\"size\":" << size << ",\"readers\":" << readers
+            << ",\"seconds\":" << seconds << ",\"reads_per_sec\":" << static_cast<double>(reads) / seconds
+            << ",\"reads_per_sec_per_reader\":" << static_cast<double>(reads) / seconds / static_cast<double>(readers)
+            << ",\"writes_per_sec\":" << static_cast<double>(writes) / seconds << "}\n";
+        out.flush();
+    }
+
+    // Байти на SKU - пам'ять магазину лише з інвентарем; на замовлення - приріст після додавання історії
+    void addMemory(const string &layout, size_t skus, size_t orders, const MemoryUsage &stocked,
+                   const MemoryUsage &full) {
+        out << "{\"memory\":";
+        out.json(layout) << ",\"skus\":" << skus << ",\"orders\":" << orders
+                         << ",\"bytes_per_sku\":" << static_cast<double>(stocked.total()) / static_cast<double>(skus)
+                         << ",\"bytes_per_order\":"
+                         << (static_cast<double>(full.total()) - static_cast<double>(stocked.total())) /
+                            static_cast<double>(orders)
+                         << ",\"inventory\":" << full.inventory << ",\"bikes\":" << full.bikes
+                         << ",\"orders_bytes\":" << full.orders << ",\"order_lines\":" << full.orderLines
+                         << ",\"strings\":" << full.strings << ",\"indexes\":" << full.indexes
+                         << ",\"analytics\":" << full.analytics << ",\"snapshots\":" << full.snapshots
+                         << ",\"total\":" << full.total() << "}\n";
+        out.flush();
+    }
+};
+
+// Інвентар з size моделей
+static void stockInventory(Shop &shop, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        string model = "Model-" + to_string(i);
+        if (i % 2) {
+            RoadBike bike(model, 54, 28, 22, 1000 + static_cast<double>(i % 5000),
+                          static_cast<AerodynamicsLevel>(1 + i % 3));
+            shop.addBike(&bike, 1 << 30);
+        } else {
+            MountainBike bike(model, 18, 29, 12, 800 + static_cast<double>(i % 3000), "Fox",
+                              i % 4 ? SuspensionType::Hardtail : SuspensionType::Full);
+            shop.addBike(&bike, 1 << 30);
+        }
+    }
+}
+
+// count замовлень по 1-3 випадкові моделі інвентаря з size моделей
+static void shipOrders(Shop &shop, size_t size, size_t count, mt19937_64 &rng) {
+    for (size_t i = 0; i < count; ++i) {
+        vector<OrderItem> items;
+        size_t lines = 1 + rng() % 3;
+        for (size_t line = 0; line < lines; ++line) {
+            items.emplace_back(shop.findBikeByModel("Model-" + to_string(rng() % size)), 1 + static_cast<int>(rng() % 2));
+        }
+        string user = "user" + to_string(rng() % (size / 4 + 1));
+        switch (i % 3) {
+            case 0:
+                shop.shipOrder(make_unique<Order>(user, std::move(items)));
+                break;
+            case 1:
+                shop.shipOrder(make_unique<FixedDiscountOrder>(user, std::move(items), 10));
+                break;
+            default:
+                shop.shipOrder(make_unique<ProgressiveDiscountOrder>(user, std::move(items)));
+        }
+    }
+}
+
+// Магазин з size моделями і size замовленнями в історії
+static void populate(Shop &shop, size_t size, mt19937_64 &rng) {
+    stockInventory(shop, size);
+    shipOrders(shop, size, size, rng);
+}
+
+// Пам'ять магазину з size моделями і size замовленнями у двох розкладках історії:
+// shipped - замовлення відправлені в процесі і посилаються на велосипеди інвентаря,
+// loaded - той самий стан, завантажений з файлу, де кожна позиція має власну копію велосипеда
+static void runMemory(const BenchConfig &config, size_t size, BenchReport &report) {
+    mt19937_64 rng(size);
+    string stockedFile = config.dir + "/bench_memory_stocked_" + to_string(size) + ".txt";
+    string fullFile = config.dir + "/bench_memory_full_" + to_string(size) + ".txt";
+    Shop shop;
+    stockInventory(shop, size);
+    shop.saveAllDataToFile(stockedFile);
+    auto stocked = shop.memoryUsage();
+    shipOrders(shop, size, size, rng);
+    shop.saveAllDataToFile(fullFile);
+    report.addMemory("shipped", size, size, stocked, shop.memoryUsage());
+
+    Shop stockedLoaded, loaded;
+    stockedLoaded.loadFromfile(stockedFile);
+    loaded.loadFromfile(fullFile);
+    report.addMemory("loaded", size, size, stockedLoaded.memoryUsage(), loaded.memoryUsage());
+    remove(stockedFile.c_str());
+    remove(fullFile.c_str());
+}
+
+static void runSize(const BenchConfig &config, size_t size, BenchReport &report) {
+    mt19937_64 rng(size);
+    Shop shop;
+    populate(shop, size, rng);
+    size_t ops = min(config.ops, size);
+
+    // Назви заздалегідь, щоб їх побудова не потрапляла у вимір
+    vector<string> existing(ops);
+    for (auto &model: existing) {
+        model = "Model-" + to_string(rng() % size);
+    }
+
+    vector<Sample> samples;
+    for (size_t r = 0; r < config.repeat; ++r) {
+        vector<string> fresh(ops);
+        for (size_t i = 0; i < ops; ++i) {
+            fresh[i] = "Fresh-" + to_string(r) + "-" + to_string(i);
+        }
+        vector<unique_ptr<RoadBike>> bikes;
+        for (const auto &model: fresh) {
+            bikes.push_back(make_unique<RoadBike>(model, 54, 28, 22, 1500, AerodynamicsLevel::SemiAero));
+        }
+        samples.push_back(measure(ops, [&](size_t i) { shop.addBike(bikes[i].get(), 10); }));
+        // Додані моделі одразу видаляються, щоб розмір каталогу не змінювався між повторами
+        for (const auto &model: fresh) shop.removeBike(model);
+    }
+    report.add("addBike", size, ops, samples);
+
+    samples.clear();
+    Bike *found = nullptr;
+    for (size_t r = 0; r < config.repeat; ++r) {
+        samples.push_back(measure(ops, [&](size_t i) { found = shop.findBikeByModel(existing[i]); }));
+    }
+    if (!found) throw runtime_error("Benchmark lookup failed.");
+    report.add("findBikeByModel", size, ops, samples);
+
+    samples.clear();
+    const CatalogRecord *record = nullptr;
+    for (size_t r = 0; r < config.repeat; ++r) {
+        samples.push_back(measure(ops, [&](size_t i) { record = shop.catalogSnapshot().find(existing[i]); }));
+    }
+    if (!record) throw runtime_error("Benchmark lookup failed.");
+    report.add("catalogSnapshot.find", size, ops, samples);
+
+    samples.clear();
+    for (size_t r = 0; r < config.repeat; ++r) {
+        samples.push_back(measure(ops, [&](size_t i) { shop.restockBike(existing[i], 1); }));
+    }
+    report.add("restockBike", size, ops, samples);
+
+    samples.clear();
+    for (size_t r = 0; r < config.repeat; ++r) {
+        vector<string> fresh(ops);
+        for (size_t i = 0; i < ops; ++i) {
+            fresh[i] = "Removed-" + to_string(r) + "-" + to_string(i);
+            RoadBike bike(fresh[i], 54, 28, 22, 1500, AerodynamicsLevel::SemiAero);
+            shop.addBike(&bike, 10);
+        }
+        samples.push_back(measure(ops, [&](size_t i) { shop.removeBike(fresh[i]); }));
+    }
+    report.add("removeBike", size, ops, samples);
+
+    samples.clear();
+    for (size_t r = 0; r < config.repeat; ++r) {
+        // Замовлення готуються заздалегідь; вимірюється лише відправка
+        vector<unique_ptr<Order>> pending;
+        pending.reserve(ops);
+        for (size_t i = 0; i < ops; ++i) {
+            vector<OrderItem> items;
+            items.emplace_back(shop.findBikeByModel(existing[i]), 1);
+            items.emplace_back(shop.findBikeByModel(existing[ops - 1 - i]), 1);
+            pending.push_back(make_unique<FixedDiscountOrder>("bench", std::move(items), 5));
+        }
+        samples.push_back(measure(ops, [&](size_t i) { shop.shipOrder(std::move(pending[i])); }));
+    }
+    report.add("shipOrder", size, ops, samples);
+
+    samples.clear();
+    auto history = shop.pageOrders(0, size);
+    volatile double total = 0;
+    for (size_t r = 0; r < config.repeat; ++r) {
+        samples.push_back(measure(ops, [&](size_t i) {
+            total = total + history.items[(i * 7919) % history.items.size()]->calculateTotalPrice();
+        }));
+    }
+    report.add("calculateTotalPrice", size, ops, samples);
+
+    // Знімок зберігається і завантажується повністю: одна операція на повтор
+    string file = config.dir + "/bench_snapshot_" + to_string(size) + ".txt";
+    samples.clear();
+    for (size_t r = 0; r < config.repeat; ++r) {
+        samples.push_back(measure(1, [&](size_t) { shop.saveAllDataToFile(file); }));
+    }
+    report.add("saveAllDataToFile", size, 1, samples);
+
+    samples.clear();
+    for (size_t r = 0; r < config.repeat; ++r) {
+        Shop loaded;
+        samples.push_back(measure(1, [&](size_t) { loaded.loadFromfile(file); }));
+    }
+    report.add("loadFromfile", size, 1, samples);
+    remove(file.c_str());
+}
+
+// Читачі знімків у config.snapshotReaders потоках протягом секунди; основний потік тим часом
+// відправляє замовлення на дві моделі і змінює ціну третьої (як editBike)
+static void runReaders(const BenchConfig &config, size_t size, BenchReport &report) {
+    mt19937_64 rng(size);
+    Shop shop;
+    stockInventory(shop, size);
+    vector<string> models(max<size_t>(config.ops, 1));
+    for (auto &model: models) {
+        model = "Model-" + to_string(rng() % size);
+    }
+
+    atomic<bool> stop{false};
+    atomic<uint64_t> missed{0};
+    vector<uint64_t> reads(config.snapshotReaders);
+    vector<thread> readers;
+    for (size_t t = 0; t < config.snapshotReaders; ++t) {
+        readers.emplace_back([&, t] {
+            uint64_t done = 0;
+            for (size_t i = t; !stop.load(memory_order_relaxed); ++i, ++done) {
+                auto snapshot = shop.catalogSnapshot();
+                if (!snapshot.find(models[i % models.size()])) missed.fetch_add(1, memory_order_relaxed);
+            }
+            reads[t] = done;
+        });
+    }
+
+    uint64_t writes = 0;
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + chrono::seconds(1);
+    for (size_t i = 0; chrono::steady_clock::now() < deadline; ++i) {
+        vector<OrderItem> items;
+        items.emplace_back(shop.findBikeByModel(models[i % models.size()]), 1);
+        items.emplace_back(shop.findBikeByModel(models[(i + 1) % models.size()]), 1);
+        shop.shipOrder(make_unique<Order>("bench", std::move(items)));
+        shop.findBikeByModel(models[(i + 2) % models.size()])->setPrice(1000 + static_cast<double>(i % 500));
+        writes += 2;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stop = true;
+    for (auto &reader: readers) reader.join();
+    if (missed) throw runtime_error("Snapshot lookup failed.");
+
+    uint64_t total = 0;
+    for (uint64_t done: reads) total += done;
+    report.addReaders(size, config.snapshotReaders, total, writes, seconds);
+}
+
+// Операція траси; розбирається заздалегідь, щоб розбір не потрапляв у вимір
+struct TraceOp {
+    enum class Kind {
+        Ship,
+        Restock,
+        Find,
+        Add,
+        Remove,
+        Save
+    } kind;
+    string model;            // restock, find, remove
+    int quantity = 0;        // restock, add
+    int orderType = 0;       // ship
+    float discount = 0;      // ship
+    string user;             // ship
+    vector<pair<string, int>> lines; // ship: модель і кількість
+    string bike;             // add: велосипед у форматі файлу даних
+};
+
+static vector<TraceOp> readTrace(const string &file) {
+    ifstream input(file);
+    if (!input) throw runtime_error("Couldn't open the trace file");
+    vector<TraceOp> ops;
+    string line;
+    while (getline(input, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        string name;
+        fields >> name;
+        TraceOp op{};
+        if (name == "ship") {
+            op.kind = TraceOp::Kind::Ship;
+            size_t count;
+            fields >> op.orderType >> op.discount >> op.user >> count;
+            op.lines.resize(count);
+            for (auto &[model, quantity]: op.lines) fields >> model >> quantity;
+        } else if (name == "restock") {
+            op.kind = TraceOp::Kind::Restock;
+            fields >> op.model >> op.quantity;
+        } else if (name == "find") {
+            op.kind = TraceOp::Kind::Find;
+            fields >> op.model;
+        } else if (name == "add") {
+            op.kind = TraceOp::Kind::Add;
+            // Кількість - останнє поле рядка, решта - опис велосипеда
+            auto last = line.find_last_of(' ');
+            op.bike = line.substr(4, last - 4);
+            op.quantity = stoi(line.substr(last + 1));
+        } else if (name == "remove") {
+            op.kind = TraceOp::Kind::Remove;
+            fields >> op.model;
+        } else if (name == "save") {
+            op.kind = TraceOp::Kind::Save;
+        } else {
+            throw runtime_error("Unknown trace operation: " + name);
+        }
+        if (!fields && op.kind != TraceOp::Kind::Add) throw runtime_error("Malformed trace line: " + line);
+        ops.push_back(std::move(op));
+    }
+    return ops;
+}
+
+// Завантаження набору даних і відтворення траси; кожен повтор починається з нового завантаження
+static void runReplay(const BenchConfig &config, BenchReport &report) {
+    static constexpr const char *kindNames[] = {"trace:ship", "trace:restock", "trace:find",
+                                                "trace:add", "trace:remove", "trace:save"};
+    vector<TraceOp> ops;
+    if (!config.trace.empty()) ops = readTrace(config.trace);
+    array<size_t, size(kindNames)> counts{};
+    for (const auto &op: ops) ++counts[static_cast<size_t>(op.kind)];
+
+    string snapshot = config.dir + "/bench_trace_snapshot.txt";
+    vector<Sample> loads;
+    array<vector<Sample>, size(kindNames)> samples;
+    size_t failed = 0;
+    for (size_t r = 0; r < config.repeat; ++r) {
+        Shop shop;
+        loads.push_back(measure(1, [&](size_t) { shop.loadFromfile(config.data); }));
+        array<Sample, size(kindNames)> totals{};
+        for (const auto &op: ops) {
+            auto kind = static_cast<size_t>(op.kind);
+            Sample sample;
+            try {
+                switch (op.kind) {
+                    case TraceOp::Kind::Ship: {
+                        vector<OrderItem> items;
+                        for (const auto &[model, quantity]: op.lines) {
+                            Bike *bike = shop.findBikeByModel(model);
+                            if (!bike) throw runtime_error("Unknown model in trace.");
+                            items.emplace_back(bike, quantity);
+                        }
+                        unique_ptr<Order> order;
+                        if (op.orderType == 1) {
+                            order = make_unique<FixedDiscountOrder>(op.user, std::move(items), op.discount);
+                        } else if (op.orderType == 2) {
+                            order = make_unique<ProgressiveDiscountOrder>(op.user, std::move(items));
+                        } else {
+                            order = make_unique<Order>(op.user, std::move(items));
+                        }
+                        sample = measure(1, [&](size_t) { shop.shipOrder(std::move(order)); });
+                        break;
+                    }
+                    case TraceOp::Kind::Restock:
+                        sample = measure(1, [&](size_t) { shop.restockBike(op.model, op.quantity); });
+                        break;
+                    case TraceOp::Kind::Find: {
+                        Bike *found = nullptr;
+                        sample = measure(1, [&](size_t) { found = shop.findBikeByModel(op.model); });
+                        if (!found) throw runtime_error("Unknown model in trace.");
+                        break;
+                    }
+                    case TraceOp::Kind::Add: {
+                        istringstream input(op.bike);
+                        unique_ptr<Bike> bike(shop.loadBikeFromFile(input));
+                        sample = measure(1, [&](size_t) { shop.addBike(bike.get(), op.quantity); });
+                        break;
+                    }
+                    case TraceOp::Kind::Remove:
+                        sample = measure(1, [&](size_t) { shop.removeBike(op.model); });
+                        break;
+                    case TraceOp::Kind::Save:
+                        sample = measure(1, [&](size_t) { shop.saveAllDataToFile(snapshot); });
+                        break;
+                }
+            } catch (exception &) {
+                // Відхилені операції (наприклад, нестача товару) не враховуються у часі
+                ++failed;
+                continue;
+            }
+            totals[kind].nanoseconds += sample.nanoseconds;
+            totals[kind].allocations += sample.allocations;
+            totals[kind].bytes += sample.bytes;
+        }
+        for (size_t kind = 0; kind < totals.size(); ++kind) samples[kind].push_back(totals[kind]);
+    }
+
+    report.add("loadFromfile:" + config.data, ops.size(), 1, loads);
+    for (size_t kind = 0; kind < samples.size(); ++kind) {
+        if (counts[kind]) report.add(kindNames[kind], ops.size(), counts[kind], samples[kind]);
+    }
+    if (failed) cerr << "Rejected trace operations: " << failed / config.repeat << " per replay" << endl;
+    remove(snapshot.c_str());
+}
+
+static vector<size_t> parseSizes(const string &list) {
+    vector<size_t> sizes;
+    stringstream input(list);
+    string token;
+    while (getline(input, token, ',')) {
+        // Допускається запис 1e6
+        sizes.push_back(static_cast<size_t>(stod(token)));
+    }
+    if (sizes.empty()) throw invalid_argument("No benchmark sizes given.");
+    return sizes;
+}
+
+int main(int argc, char **argv) {
+    BenchConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            auto value = [&](const string &key) { return arg.substr(key.size()); };
+            if (arg.rfind("--sizes=", 0) == 0) config.sizes = parseSizes(value("--sizes="));
+            else if (arg.rfind("--ops=", 0) == 0) config.ops = max<size_t>(1, stoul(value("--ops=")));
+            else if (arg.rfind("--repeat=", 0) == 0) config.repeat = max<size_t>(1, stoul(value("--repeat=")));
+            else if (arg.rfind("--dir=", 0) == 0) config.dir = value("--dir=");
+            else if (arg.rfind("--data=", 0) == 0) config.data = value("--data=");
+            else if (arg.rfind("--trace=", 0) == 0) config.trace = value("--trace=");
+            else if (arg == "--latency") config.latency = true;
+            else if (arg.rfind("--latency-sample=", 0) == 0) {
+                LatencyMetrics::setSampleInterval(static_cast<uint32_t>(stoul(value("--latency-sample="))));
+            }
+            else if (arg == "--allocations") config.allocations = true;
+            else if (arg.rfind("--chrome-trace=", 0) == 0) config.chromeTrace = value("--chrome-trace=");
+            else if (arg == "--memory") config.memory = true;
+            else if (arg.rfind("--readers=", 0) == 0) config.snapshotReaders = max<size_t>(1, stoul(value("--readers=")));
+            else throw invalid_argument("Unknown argument: " + arg);
+        }
+
+        // Повідомлення магазину не виводяться, щоб не вимірювати консоль
+        cout.setstate(ios::failbit);
+        BenchReport report;
+        AllocationTracker::enable(config.allocations);
+        Tracer::enable(!config.chromeTrace.empty());
+        if (!config.trace.empty() && config.data.empty()) throw invalid_argument("Trace replay needs --data.");
+        if (!config.data.empty()) {
+            runReplay(config, report);
+        } else {
+            for (size_t size: config.sizes) {
+                if (config.memory) runMemory(config, size, report);
+                else if (config.snapshotReaders) runReaders(config, size, report);
+                else runSize(config, size, report);
+            }
+        }
+        if (config.latency) {
+            FileSink sink(stdout);
+            ReportWriter out(sink);
+            out << "{\"latency\":";
+            LatencyMetrics::writeJson(out);
+            out << ",\"sample_interval\":" << LatencyMetrics::getSampleInterval() << "}\n";
+        }
+        if (config.allocations) {
+            FileSink sink(stdout);
+            ReportWriter out(sink);
+            out << "{\"allocations\":";
+            AllocationTracker::writeJson(out);
+            out << "}\n";
+        }
+        if (!config.chromeTrace.empty()) Tracer::writeChromeJsonToFile(config.chromeTrace);
+    } catch (exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
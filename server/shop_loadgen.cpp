@@ -0,0 +1,321 @@
+#include "server/shop_protocol.h"
+
+#include <csignal>
+#include <random>
+#include <sys/epoll.h>
+
+// Навантажувальний клієнт сервера магазину із замкненим циклом (лише Linux)
+// Запуск: Indiv_OOP_loadgen [--connect=127.0.0.1:7070 | --connect=unix:/tmp/shop.sock] [--threads=N]
+//         [--connections=64] [--pipeline=8] [--duration=10] [--warmup=1] [--models=1000]
+//         [--mix=find:50,quote:20,ship:15,restock:10,stats:5] [--seed=1]
+// Кожне з'єднання тримає pipeline запитів у польоті: на кожну відповідь одразу надсилається наступний
+// запит. Назви моделей беруться у сервера посторінково перед стартом. Результат - один рядок JSON
+// з пропускною здатністю і квантилями затримки від надсилання запиту до отримання відповіді
+
+struct LoadConfig {
+    string connect = "127.0.0.1:7070";
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    size_t connections = 64;
+    size_t pipeline = 8;
+    double duration = 10;
+    double warmup = 1;
+    size_t models = 1000;
+    vector<pair<ShopOpcode, unsigned>> mix{{ShopOpcode::Find,    50},
+                                           {ShopOpcode::Quote,   20},
+                                           {ShopOpcode::Ship,    15},
+                                           {ShopOpcode::Restock, 10},
+                                           {ShopOpcode::Stats,   5}};
+    uint64_t seed = 1;
+};
+
+// Підсумок одного потоку клієнта
+struct LoadResult {
+    LatencySnapshot latency; // Такти MetricsClock
+    array<uint64_t, 4> statuses{}; // За ShopStatus
+    uint64_t requests = 0;
+
+    void merge(const LoadResult &other) {
+        latency.merge(other.latency);
+        for (size_t i = 0; i < statuses.size(); ++i) statuses[i] += other.statuses[i];
+        requests += other.requests;
+    }
+};
+
+static vector<pair<ShopOpcode, unsigned>> parseMix(const string &text) {
+    static const map<string, ShopOpcode> names{{"find",    ShopOpcode::Find},
+                                               {"restock", ShopOpcode::Restock},
+                                               {"ship",    ShopOpcode::Ship},
+                                               {"quote",   ShopOpcode::Quote},
+                                               {"stats",   ShopOpcode::Stats}};
+    vector<pair<ShopOpcode, unsigned>> mix;
+    stringstream input(text);
+    string part;
+    while (getline(input, part, ',')) {
+        auto colon = part.find(':');
+        auto it = names.find(part.substr(0, colon));
+        if (colon == string::npos || it == names.end()) throw invalid_argument("Invalid mix entry: " + part);
+        mix.emplace_back(it->second, static_cast<unsigned>(stoul(part.substr(colon + 1))));
+    }
+    if (mix.empty()) throw invalid_argument("Operation mix must not be empty.");
+    return mix;
+}
+
+// Блокуюче з'єднання для підготовчих запитів
+static int connectBlocking(const ShopEndpoint &endpoint) {
+    int fd = endpoint.openSocket();
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    if (connect(fd, reinterpret_cast<const sockaddr *>(&endpoint.address), endpoint.length) < 0) {
+        string message = strerror(errno);
+        close(fd);
+        throw runtime_error("Failed to connect: " + message);
+    }
+    return fd;
+}
+
+// Назви до limit моделей інвентаря сервера, сторінками по 512
+static vector<string> fetchModels(const ShopEndpoint &endpoint, size_t limit) {
+    int fd = connectBlocking(endpoint);
+    vector<string> models;
+    string request, input;
+    uint64_t cursor = 0;
+    try {
+        while (models.size() < limit) {
+            request.clear();
+            FrameWriter(request, 0, static_cast<uint8_t>(ShopOpcode::Page))
+                    .u64(cursor).u16(static_cast<uint16_t>(min<size_t>(512, limit - models.size()))).finish();
+            if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+                throw runtime_error("Failed to send request.");
+            }
+            size_t consumed = 0;
+            optional<Frame> frame;
+            while (!(frame = parseFrame(input, consumed))) {
+                char buffer[64 * 1024];
+                ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+                if (received <= 0) throw runtime_error("Server closed the connection.");
+                input.append(buffer, static_cast<size_t>(received));
+            }
+            if (frame->code != static_cast<uint8_t>(ShopStatus::Ok)) throw runtime_error("Page request failed.");
+            FrameReader reader(frame->body);
+            cursor = reader.u64();
+            uint16_t count = reader.u16();
+            for (uint16_t i = 0; i < count; ++i) models.emplace_back(reader.str());
+            input.erase(0, consumed);
+            if (cursor == 0) break;
+        }
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    if (models.empty()) throw runtime_error("Server inventory is empty.");
+    return models;
+}
+
+class LoadWorker {
+    struct Connection {
+        int fd = -1;
+        string output;
+        size_t written = 0;
+        string input;
+        deque<uint64_t> sentAt; // Час надсилання запитів у польоті, у порядку надсилання
+    };
+
+    const LoadConfig &config;
+    const vector<string> &models;
+    mt19937_64 rng;
+    discrete_distribution<size_t> operations;
+    uint32_t nextId = 1;
+
+    void writeRequest(Connection &connection) {
+        auto opcode = config.mix[operations(rng)].first;
+        const string &model = models[rng() % models.size()];
+        FrameWriter request(connection.output, nextId++, static_cast<uint8_t>(opcode));
+        switch (opcode) {
+            case ShopOpcode::Find:
+                request.str(model);
+                break;
+            case ShopOpcode::Restock:
+                request.str(model).u32(1 + static_cast<uint32_t>(rng() % 20));
+                break;
+            case ShopOpcode::Ship:
+            case ShopOpcode::Quote: {
+                auto lines = static_cast<uint16_t>(1 + rng() % 3);
+                request.str("load" + to_string(rng() % 10000)).u8(static_cast<uint8_t>(rng() % 3)).f64(10).u16(lines);
+                for (uint16_t line = 0; line < lines; ++line) {
+                    request.str(line ? models[rng() % models.size()] : model).u32(1);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        request.finish();
+        connection.sentAt.push_back(MetricsClock::now());
+    }
+
+    static bool flush(Connection &connection) {
+        while (connection.written < connection.output.size()) {
+            ssize_t sent = send(connection.fd, connection.output.data() + connection.written,
+                                connection.output.size() - connection.written, MSG_NOSIGNAL);
+            if (sent < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            connection.written += static_cast<size_t>(sent);
+        }
+        connection.output.clear();
+        connection.written = 0;
+        return true;
+    }
+
+    // Обробка відповідей і надсилання замість них нових запитів; false, якщо з'єднання втрачене
+    bool serve(Connection &connection, LoadResult &result, uint64_t measureFrom, bool sending) {
+        char buffer[64 * 1024];
+        while (true) {
+            ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (received == 0) return false;
+            if (received < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+                break;
+            }
+            connection.input.append(buffer, static_cast<size_t>(received));
+            size_t offset = 0, consumed = 0;
+            uint64_t now = MetricsClock::now();
+            while (auto frame = parseFrame(string_view(connection.input).substr(offset), consumed)) {
+                offset += consumed;
+                if (connection.sentAt.empty()) return false; // Відповідь без запиту
+                uint64_t sentAt = connection.sentAt.front();
+                connection.sentAt.pop_front();
+                if (sentAt >= measureFrom) {
+                    result.latency.add(now - sentAt);
+                    ++result.statuses[min<size_t>(frame->code, result.statuses.size() - 1)];
+                    ++result.requests;
+                }
+                if (sending) writeRequest(connection);
+            }
+            connection.input.erase(0, offset);
+        }
+        return flush(connection);
+    }
+
+public:
+    LoadWorker(const LoadConfig &config, const vector<string> &models, uint64_t seed)
+            : config(config), models(models), rng(seed) {
+        vector<double> weights;
+        for (const auto &[opcode, weight]: config.mix) weights.push_back(weight);
+        operations = discrete_distribution<size_t>(weights.begin(), weights.end());
+    }
+
+    LoadResult run(const ShopEndpoint &endpoint, size_t connectionCount, chrono::steady_clock::time_point start) {
+        LoadResult result;
+        int poll = epoll_create1(EPOLL_CLOEXEC);
+        if (poll < 0) throw runtime_error(string("epoll_create1 failed: ") + strerror(errno));
+        vector<Connection> connections(connectionCount);
+        for (size_t i = 0; i < connectionCount; ++i) {
+            Connection &connection = connections[i];
+            connection.fd = connectBlocking(endpoint);
+            fcntl(connection.fd, F_SETFL, fcntl(connection.fd, F_GETFL) | O_NONBLOCK);
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+            event.data.u64 = i;
+            epoll_ctl(poll, EPOLL_CTL_ADD, connection.fd, &event);
+            for (size_t k = 0; k < config.pipeline; ++k) writeRequest(connection);
+            flush(connection);
+        }
+
+        auto measureStart = start + chrono::duration_cast<chrono::steady_clock::duration>(
+                chrono::duration<double>(config.warmup));
+        auto finish = measureStart + chrono::duration_cast<chrono::steady_clock::duration>(
+                chrono::duration<double>(config.duration));
+        uint64_t measureFrom = UINT64_MAX;
+        array<epoll_event, 256> events{};
+        size_t open = connectionCount;
+        while (open > 0) {
+            auto now = chrono::steady_clock::now();
+            if (now >= finish) break;
+            if (measureFrom == UINT64_MAX && now >= measureStart) measureFrom = MetricsClock::now();
+            int ready = epoll_wait(poll, events.data(), static_cast<int>(events.size()), 100);
+            for (int i = 0; i < ready; ++i) {
+                Connection &connection = connections[events[i].data.u64];
+                if (connection.fd < 0) continue;
+                if (!serve(connection, result, measureFrom, true)) {
+                    close(connection.fd);
+                    connection.fd = -1;
+                    --open;
+                }
+            }
+        }
+        for (auto &connection: connections) {
+            if (connection.fd >= 0) close(connection.fd);
+        }
+        close(poll);
+        if (open < connectionCount) cerr << "Lost " << connectionCount - open << " connections" << endl;
+        return result;
+    }
+};
+
+int main(int argc, char **argv) {
+    LoadConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            auto value = [&](const string &key) { return arg.substr(key.size()); };
+            if (arg.rfind("--connect=", 0) == 0) config.connect = value("--connect=");
+            else if (arg.rfind("--threads=", 0) == 0) config.threads = max(1u, static_cast<unsigned>(stoul(value("--threads="))));
+            else if (arg.rfind("--connections=", 0) == 0) config.connections = max<size_t>(1, stoul(value("--connections=")));
+            else if (arg.rfind("--pipeline=", 0) == 0) config.pipeline = max<size_t>(1, stoul(value("--pipeline=")));
+            else if (arg.rfind("--duration=", 0) == 0) config.duration = stod(value("--duration="));
+            else if (arg.rfind("--warmup=", 0) == 0) config.warmup = stod(value("--warmup="));
+            else if (arg.rfind("--models=", 0) == 0) config.models = max<size_t>(1, stoul(value("--models=")));
+            else if (arg.rfind("--mix=", 0) == 0) config.mix = parseMix(value("--mix="));
+            else if (arg.rfind("--seed=", 0) == 0) config.seed = stoull(value("--seed="));
+            else throw invalid_argument("Unknown argument: " + arg);
+        }
+        signal(SIGPIPE, SIG_IGN);
+        MetricsClock::start();
+        auto endpoint = ShopEndpoint::parse(config.connect);
+        auto models = fetchModels(endpoint, config.models);
+
+        // З'єднання розподіляються між потоками порівну; кожен потік має власний epoll
+        unsigned threadCount = static_cast<unsigned>(min<size_t>(config.threads, config.connections));
+        vector<LoadResult> results(threadCount);
+        vector<thread> workers;
+        auto start = chrono::steady_clock::now();
+        for (unsigned t = 0; t < threadCount; ++t) {
+            size_t share = config.connections / threadCount + (t < config.connections % threadCount ? 1 : 0);
+            workers.emplace_back([&, t, share] {
+                try {
+                    LoadWorker worker(config, models, config.seed * 1000003 + t);
+                    results[t] = worker.run(endpoint, share, start);
+                } catch (exception &e) {
+                    cerr << "Error: " << e.what() << endl;
+                }
+            });
+        }
+        for (auto &worker: workers) worker.join();
+
+        LoadResult total;
+        for (const auto &result: results) total.merge(result);
+        double microseconds = MetricsClock::nanosecondsPerTick() / 1000;
+        const auto &latency = total.latency;
+        FileSink sink(stdout);
+        ReportWriter out(sink);
+        out << "{\"connections\":" << config.connections << ",\"pipeline\":" << config.pipeline
+            << ",\"threads\":" << threadCount << ",\"seconds\":" << config.duration
+            << ",\"requests\":" << total.requests
+            << ",\"requests_per_sec\":" << static_cast<double>(total.requests) / config.duration
+            << ",\"mean_us\":"
+            << (latency.count ? static_cast<double>(latency.total) / static_cast<double>(latency.count) * microseconds : 0.0)
+            << ",\"p50_us\":" << latency.quantile(0.5) * microseconds
+            << ",\"p99_us\":" << latency.quantile(0.99) * microseconds
+            << ",\"p999_us\":" << latency.quantile(0.999) * microseconds
+            << ",\"max_us\":" << static_cast<double>(latency.max) * microseconds
+            << ",\"ok\":" << total.statuses[static_cast<size_t>(ShopStatus::Ok)]
+            << ",\"not_found\":" << total.statuses[static_cast<size_t>(ShopStatus::NotFound)]
+            << ",\"rejected\":" << total.statuses[static_cast<size_t>(ShopStatus::Rejected)]
+            << ",\"bad_request\":" << total.statuses[static_cast<size_t>(ShopStatus::BadRequest)] << "}\n";
+        out.flush();
+    } catch (exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+#ifndef INDIV_OOP_SHOP_PROTOCOL_H
+#define INDIV_OOP_SHOP_PROTOCOL_H
+
+#include "shop.h"
+
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Двійковий протокол сервера магазину (лише Linux)
+// Кадр: розмір тіла (u32), номер запиту (u32), код операції у запиті або статус у відповіді (u8), тіло
+// Числа - little-endian, дробові - IEEE 754 double, рядки - довжина (u16) і байти
+// Клієнт може надсилати запити один за одним, не чекаючи відповідей: сервер відповідає
+// на кожне з'єднання в порядку запитів, з тим самим номером
+static_assert(endian::native == endian::little, "Shop protocol assumes a little-endian host.");
+
+// Тіла запитів і відповідей зі статусом Ok:
+//   Find    model                      -> price, available (i32)
+//   Restock model, quantity (u32)      -> available (i32)
+//   Ship    order                      -> total
+//   Quote   order                      -> total (без відправки)
+//   Stats   -                          -> sold (i64), revenue, orders (u64), skus (u64)
+//   Page    cursor (u64), count (u16)  -> next (u64, 0 - кінець), count (u16), model...
+// order = user, type (u8), discount, lines (u16), [model, quantity (u32)]...
+// Інші статуси мають тілом повідомлення про помилку
+enum class ShopOpcode : uint8_t {
+    Find = 1,
+    Restock,
+    Ship,
+    Quote,
+    Stats,
+    Page
+};
+
+enum class ShopStatus : uint8_t {
+    Ok,
+    NotFound,
+    Rejected,  // Операція неможлива (нестача на складі, неправильні значення)
+    BadRequest // Пошкоджений кадр або невідома операція
+};
+
+inline constexpr size_t frameHeaderSize = 9;
+inline constexpr size_t maxFrameBody = size_t(1) << 20;
+
+// Запис кадру в кінець буфера; розмір тіла проставляється у finish()
+class FrameWriter {
+    string &out;
+    size_t start;
+
+    template<typename T>
+    void put(T value) {
+        char bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
+
+public:
+    FrameWriter(string &out, uint32_t id, uint8_t code) : out(out), start(out.size()) {
+        put<uint32_t>(0);
+        put(id);
+        put(code);
+    }
+
+    FrameWriter &u8(uint8_t value) { put(value); return *this; }
+
+    FrameWriter &u16(uint16_t value) { put(value); return *this; }
+
+    FrameWriter &u32(uint32_t value) { put(value); return *this; }
+
+    FrameWriter &i32(int32_t value) { put(value); return *this; }
+
+    FrameWriter &u64(uint64_t value) { put(value); return *this; }
+
+    FrameWriter &i64(int64_t value) { put(value); return *this; }
+
+    FrameWriter &f64(double value) { put(value); return *this; }
+
+    FrameWriter &str(string_view text) {
+        if (text.size() > UINT16_MAX) throw invalid_argument("Protocol string is too long.");
+        put(static_cast<uint16_t>(text.size()));
+        out.append(text);
+        return *this;
+    }
+
+    void finish() {
+        auto size = static_cast<uint32_t>(out.size() - start - frameHeaderSize);
+        memcpy(&out[start], &size, sizeof(size));
+    }
+};
+
+// Заголовок і тіло кадру, прочитаного з буфера
+struct Frame {
+    uint32_t id = 0;
+    uint8_t code = 0;
+    string_view body;
+};
+
+// Наступний повний кадр з початку data; nullopt, якщо кадр ще не надійшов повністю
+// consumed - кількість байтів кадру разом із заголовком
+inline optional<Frame> parseFrame(string_view data, size_t &consumed) {
+    if (data.size() < frameHeaderSize) return nullopt;
+    uint32_t size;
+    memcpy(&size, data.data(), sizeof(size));
+    if (size > maxFrameBody) throw runtime_error("Protocol frame is too large.");
+    if (data.size() < frameHeaderSize + size) return nullopt;
+    Frame frame;
+    memcpy(&frame.id, data.data() + 4, sizeof(frame.id));
+    frame.code = static_cast<uint8_t>(data[8]);
+    frame.body = data.substr(frameHeaderSize, size);
+    consumed = frameHeaderSize + size;
+    return frame;
+}
+
+// Послідовне читання тіла кадру; нестача байтів - пошкоджений кадр
+class FrameReader {
+    string_view body;
+    size_t pos = 0;
+
+    template<typename T>
+    T get() {
+        if (body.size() - pos < sizeof(T)) throw invalid_argument("Truncated protocol frame.");
+        T value;
+        memcpy(&value, body.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+public:
+    explicit FrameReader(string_view body) : body(body) {}
+
+    uint8_t u8() { return get<uint8_t>(); }
+
+    uint16_t u16() { return get<uint16_t>(); }
+
+    uint32_t u32() { return get<uint32_t>(); }
+
+    int32_t i32() { return get<int32_t>(); }
+
+    uint64_t u64() { return get<uint64_t>(); }
+
+    int64_t i64() { return get<int64_t>(); }
+
+    double f64() { return get<double>(); }
+
+    string_view str() {
+        uint16_t size = u16();
+        if (body.size() - pos < size) throw invalid_argument("Truncated protocol frame.");
+        auto text = body.substr(pos, size);
+        pos += size;
+        return text;
+    }
+};
+
+// Адреса сервера: "unix:/шлях" або "хост:порт" (IPv4)
+struct ShopEndpoint {
+    sockaddr_storage address{};
+    socklen_t length = 0;
+    string unixPath;
+
+    static ShopEndpoint parse(const string &text) {
+        ShopEndpoint endpoint;
+        if (text.rfind("unix:", 0) == 0) {
+            endpoint.unixPath = text.substr(5);
+            auto *local = reinterpret_cast<sockaddr_un *>(&endpoint.address);
+            if (endpoint.unixPath.empty() || endpoint.unixPath.size() >= sizeof(local->sun_path)) {
+                throw invalid_argument("Invalid Unix socket path: " + text);
+            }
+            local->sun_family = AF_UNIX;
+            memcpy(local->sun_path, endpoint.unixPath.c_str(), endpoint.unixPath.size() + 1);
+            endpoint.length = sizeof(sockaddr_un);
+            return endpoint;
+        }
+        auto colon = text.rfind(':');
+        if (colon == string::npos) throw invalid_argument("Endpoint must be host:port or unix:path: " + text);
+        auto *inet = reinterpret_cast<sockaddr_in *>(&endpoint.address);
+        inet->sin_family = AF_INET;
+        inet->sin_port = htons(static_cast<uint16_t>(stoul(text.substr(colon + 1))));
+        if (inet_pton(AF_INET, text.substr(0, colon).c_str(), &inet->sin_addr) != 1) {
+            throw invalid_argument("Invalid IPv4 address: " + text);
+        }
+        endpoint.length = sizeof(sockaddr_in);
+        return endpoint;
+    }
+
+    [[nodiscard]] bool isUnix() const { return !unixPath.empty(); }
+
+    // Неблокуючий сокет потрібного сімейства; для TCP вимикається алгоритм Нейгла
+    [[nodiscard]] int openSocket() const {
+        int fd = socket(address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) throw runtime_error(string("socket failed: ") + strerror(errno));
+        if (!isUnix()) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        return fd;
+    }
+};
+
+#endif //INDIV_OOP_SHOP_PROTOCOL_H
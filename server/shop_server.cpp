@@ -0,0 +1,328 @@
+#include "server/shop_protocol.h"
+
+#include <csignal>
+#include <shared_mutex>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+// Сервер магазину для навантажувального тестування (лише Linux)
+// Запуск: Indiv_OOP_server [--data=data.txt] [--listen=127.0.0.1:7070 | --listen=unix:/tmp/shop.sock]
+//         [--threads=N] [--save=output.txt]
+// Протокол описаний у shop_protocol.h. Кожен робочий потік має власний epoll і обслуговує прийняті
+// ним з'єднання; запити, що надійшли разом, обробляються однією партією під одним блокуванням магазину
+// (пошук і сторінки читають знімок інвентарю без блокування),
+// а відповіді на них надсилаються одним записом. Зупинка - SIGINT або SIGTERM; після неї в stderr
+// виводяться гістограми затримок операцій, а з --save стан магазину зберігається у файл
+
+struct ServerConfig {
+    string data;
+    string listen = "127.0.0.1:7070";
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    string save;
+};
+
+static int stopEvent = -1; // eventfd, яким обробник сигналу будить усі робочі потоки
+
+static void requestStop(int) {
+    uint64_t one = 1;
+    (void) !write(stopEvent, &one, sizeof(one));
+}
+
+class ShopServer {
+    static constexpr size_t readChunk = 64 * 1024;
+    static constexpr size_t maxPendingOutput = 4 * 1024 * 1024; // Далі запити не читаються, доки клієнт не прийме відповіді
+
+    struct Connection {
+        int fd;
+        string input;
+        string output;
+        size_t written = 0;
+    };
+
+    Shop &shop;
+    shared_mutex shopLock; // Розрахунок і статистика - спільно; відправка і поповнення - виключно
+    int listener;
+
+    static bool modifiesShop(uint8_t code) {
+        return code == static_cast<uint8_t>(ShopOpcode::Restock) || code == static_cast<uint8_t>(ShopOpcode::Ship);
+    }
+
+    // Пошук і сторінки читають знімок інвентарю і не потребують блокування магазину
+    static bool readsSnapshot(uint8_t code) {
+        return code == static_cast<uint8_t>(ShopOpcode::Find) || code == static_cast<uint8_t>(ShopOpcode::Page);
+    }
+
+    // Замовлення з тіла запиту; позиції посилаються на велосипеди інвентаря
+    unique_ptr<Order> readOrder(FrameReader &reader) {
+        string user(reader.str());
+        auto type = static_cast<OrderType>(reader.u8());
+        double discount = reader.f64();
+        uint16_t lines = reader.u16();
+        vector<OrderItem> items;
+        items.reserve(lines);
+        for (uint16_t i = 0; i < lines; ++i) {
+            string model(reader.str());
+            uint32_t quantity = reader.u32();
+            Bike *bike = shop.findBikeByModel(model);
+            if (!bike) throw out_of_range("Bike " + model + " not found in inventory.");
+            items.emplace_back(bike, static_cast<int>(min<uint32_t>(quantity, INT32_MAX)));
+        }
+        switch (type) {
+            case OrderType::Standard:
+                return make_unique<Order>(user, std::move(items));
+            case OrderType::FixedDiscount:
+                return make_unique<FixedDiscountOrder>(user, std::move(items), static_cast<float>(discount));
+            case OrderType::ProgressiveDiscount:
+                return make_unique<ProgressiveDiscountOrder>(user, std::move(items));
+        }
+        throw invalid_argument("Unknown order type.");
+    }
+
+    void handle(const Frame &frame, string &output) {
+        FrameReader reader(frame.body);
+        auto fail = [&](ShopStatus status, const string &message) {
+            FrameWriter(output, frame.id, static_cast<uint8_t>(status)).str(message.substr(0, 1024)).finish();
+        };
+        try {
+            switch (static_cast<ShopOpcode>(frame.code)) {
+                case ShopOpcode::Find: {
+                    string_view model = reader.str();
+                    auto snapshot = shop.catalogSnapshot();
+                    const CatalogRecord *record = snapshot.find(model);
+                    if (!record) {
+                        return fail(ShopStatus::NotFound, "Bike " + string(model) + " not found in inventory.");
+                    }
+                    FrameWriter(output, frame.id, static_cast<uint8_t>(ShopStatus::Ok))
+                            .f64(record->bike->getPrice()).i32(record->getAvailable()).finish();
+                    return;
+                }
+                case ShopOpcode::Restock: {
+                    string model(reader.str());
+                    uint32_t quantity = reader.u32();
+                    if (!shop.findBikeByModel(model)) {
+                        return fail(ShopStatus::NotFound, "Bike " + model + " not found in inventory.");
+                    }
+                    shop.restockBike(model, static_cast<int>(min<uint32_t>(quantity, INT32_MAX)));
+                    FrameWriter(output, frame.id, static_cast<uint8_t>(ShopStatus::Ok))
+                            .i32(shop.getAvailableQuantity(model)).finish();
+                    return;
+                }
+                case ShopOpcode::Ship:
+                case ShopOpcode::Quote: {
+                    auto order = readOrder(reader);
+                    double total = order->calculateTotalPrice();
+                    if (static_cast<ShopOpcode>(frame.code) == ShopOpcode::Ship) shop.shipOrder(std::move(order));
+                    FrameWriter(output, frame.id, static_cast<uint8_t>(ShopStatus::Ok)).f64(total).finish();
+                    return;
+                }
+                case ShopOpcode::Stats:
+                    FrameWriter(output, frame.id, static_cast<uint8_t>(ShopStatus::Ok))
+                            .i64(Shop::getTotalSoldItems()).f64(Shop::getTotalRevenue())
+                            .u64(shop.getOrderCount()).u64(shop.getInventorySize()).finish();
+                    return;
+                case ShopOpcode::Page: {
+                    uint64_t cursor = reader.u64();
+                    uint16_t count = max<uint16_t>(1, reader.u16());
+                    auto snapshot = shop.catalogSnapshot();
+                    auto page = snapshot.page(cursor, count);
+                    FrameWriter response(output, frame.id, static_cast<uint8_t>(ShopStatus::Ok));
+                    response.u64(page.next.value_or(0)).u16(static_cast<uint16_t>(page.items.size()));
+                    for (const CatalogRecord *record: page.items) response.str(record->bike->getModel());
+                    response.finish();
+                    return;
+                }
+            }
+            fail(ShopStatus::BadRequest, "Unknown operation " + to_string(frame.code) + ".");
+        } catch (out_of_range &e) {
+            fail(ShopStatus::NotFound, e.what());
+        } catch (invalid_argument &e) {
+            fail(ShopStatus::BadRequest, e.what());
+        } catch (exception &e) {
+            fail(ShopStatus::Rejected, e.what());
+        }
+    }
+
+    // Усі повні кадри з буфера обробляються однією партією під одним блокуванням;
+    // партія лише з пошуків і сторінок виконується без блокування
+    void processInput(Connection &connection) {
+        vector<Frame> batch;
+        size_t offset = 0, consumed = 0;
+        bool writes = false, snapshotOnly = true;
+        while (auto frame = parseFrame(string_view(connection.input).substr(offset), consumed)) {
+            batch.push_back(*frame);
+            writes = writes || modifiesShop(frame->code);
+            snapshotOnly = snapshotOnly && readsSnapshot(frame->code);
+            offset += consumed;
+        }
+        if (batch.empty()) return;
+        if (snapshotOnly) {
+            for (const auto &frame: batch) handle(frame, connection.output);
+        } else if (writes) {
+            unique_lock<shared_mutex> guard(shopLock);
+            for (const auto &frame: batch) handle(frame, connection.output);
+        } else {
+            shared_lock<shared_mutex> guard(shopLock);
+            for (const auto &frame: batch) handle(frame, connection.output);
+        }
+        connection.input.erase(0, offset);
+    }
+
+    // false, якщо з'єднання треба закрити
+    static bool flush(Connection &connection) {
+        while (connection.written < connection.output.size()) {
+            ssize_t sent = send(connection.fd, connection.output.data() + connection.written,
+                                connection.output.size() - connection.written, MSG_NOSIGNAL);
+            if (sent < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            connection.written += static_cast<size_t>(sent);
+        }
+        connection.output.clear();
+        connection.written = 0;
+        return true;
+    }
+
+    // Читання до вичерпання сокета (epoll у режимі за фронтом); false, якщо з'єднання закрите
+    bool serve(Connection &connection) {
+        char buffer[readChunk];
+        while (true) {
+            if (!flush(connection)) return false;
+            if (connection.output.size() - connection.written > maxPendingOutput) return true;
+            ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (received == 0) return false;
+            if (received < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            connection.input.append(buffer, static_cast<size_t>(received));
+            try {
+                processInput(connection);
+            } catch (exception &) {
+                return false; // Кадр більший за допустимий - клієнт порушує протокол
+            }
+        }
+    }
+
+    void acceptAll(int poll, unordered_map<int, Connection> &connections) {
+        while (true) {
+            int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.fd = fd;
+            if (epoll_ctl(poll, EPOLL_CTL_ADD, fd, &event) < 0) {
+                close(fd);
+                continue;
+            }
+            connections.emplace(fd, Connection{fd, {}, {}, 0});
+        }
+    }
+
+    void worker() {
+        int poll = epoll_create1(EPOLL_CLOEXEC);
+        if (poll < 0) throw runtime_error(string("epoll_create1 failed: ") + strerror(errno));
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLEXCLUSIVE; // Нове з'єднання будить лише один потік
+        event.data.fd = listener;
+        epoll_ctl(poll, EPOLL_CTL_ADD, listener, &event);
+        event.events = EPOLLIN;
+        event.data.fd = stopEvent;
+        epoll_ctl(poll, EPOLL_CTL_ADD, stopEvent, &event);
+
+        unordered_map<int, Connection> connections;
+        array<epoll_event, 256> events{};
+        bool running = true;
+        while (running) {
+            int ready = epoll_wait(poll, events.data(), static_cast<int>(events.size()), -1);
+            if (ready < 0 && errno != EINTR) break;
+            for (int i = 0; i < ready; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == stopEvent) {
+                    running = false;
+                } else if (fd == listener) {
+                    acceptAll(poll, connections);
+                } else if (auto it = connections.find(fd); it != connections.end()) {
+                    bool open = !(events[i].events & EPOLLERR) && serve(it->second);
+                    if (!open || (events[i].events & EPOLLHUP)) {
+                        close(fd);
+                        connections.erase(it);
+                    }
+                }
+            }
+        }
+        for (auto &[fd, connection]: connections) close(fd);
+        close(poll);
+    }
+
+public:
+    ShopServer(Shop &shop, const ShopEndpoint &endpoint) : shop(shop) {
+        listener = endpoint.openSocket();
+        int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (endpoint.isUnix()) unlink(endpoint.unixPath.c_str());
+        if (bind(listener, reinterpret_cast<const sockaddr *>(&endpoint.address), endpoint.length) < 0 ||
+            ::listen(listener, SOMAXCONN) < 0) {
+            string message = strerror(errno);
+            close(listener);
+            throw runtime_error("Failed to listen: " + message);
+        }
+    }
+
+    ShopServer(const ShopServer &) = delete;
+    ShopServer &operator=(const ShopServer &) = delete;
+
+    ~ShopServer() {
+        close(listener);
+    }
+
+    // Робота до сигналу зупинки; кожен потік - окремий цикл epoll
+    void run(unsigned threadCount) {
+        vector<thread> workers;
+        for (unsigned i = 0; i < threadCount; ++i) workers.emplace_back([this] { worker(); });
+        for (auto &worker: workers) worker.join();
+    }
+};
+
+int main(int argc, char **argv) {
+    ServerConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            auto value = [&](const string &key) { return arg.substr(key.size()); };
+            if (arg.rfind("--data=", 0) == 0) config.data = value("--data=");
+            else if (arg.rfind("--listen=", 0) == 0) config.listen = value("--listen=");
+            else if (arg.rfind("--threads=", 0) == 0) config.threads = max(1u, static_cast<unsigned>(stoul(value("--threads="))));
+            else if (arg.rfind("--save=", 0) == 0) config.save = value("--save=");
+            else throw invalid_argument("Unknown argument: " + arg);
+        }
+
+        // Повідомлення магазину про кожну операцію не виводяться
+        cout.setstate(ios::failbit);
+        Shop shop;
+        if (!config.data.empty()) shop.loadFromfile(config.data);
+
+        auto endpoint = ShopEndpoint::parse(config.listen);
+        stopEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (stopEvent < 0) throw runtime_error(string("eventfd failed: ") + strerror(errno));
+        signal(SIGINT, requestStop);
+        signal(SIGTERM, requestStop);
+        signal(SIGPIPE, SIG_IGN);
+        {
+            ShopServer server(shop, endpoint);
+            cerr << "Listening on " << config.listen << " with " << config.threads << " threads, "
+                 << shop.getInventorySize() << " models, " << shop.getOrderCount() << " orders" << endl;
+            server.run(config.threads);
+        }
+        if (endpoint.isUnix()) unlink(endpoint.unixPath.c_str());
+        close(stopEvent);
+
+        FileSink sink(stderr);
+        ReportWriter out(sink);
+        LatencyMetrics::writeText(out);
+        if (!config.save.empty()) shop.saveAllDataToFile(config.save);
+    } catch (exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,5585 @@
+#ifndef INDIV_OOP_SHOP_H
+#define INDIV_OOP_SHOP_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <semaphore>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <list>
+#include <set>
+#include <map>
+#include <array>
+#include <exception>
+#include <cstdint>
+#include <bit>
+#include <optional>
+#include <string_view>
+#include <queue>
+#include <limits>
+#include <cmath>
+#include <charconv>
+#include <chrono>
+#include <span>
+#include <coroutine>
+#include <deque>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// ENUMS
+
+// Тип велосипеда
+enum class BikeType {
+    Mountain,
+    Road
+};
+
+// Тип амортизації
+enum class SuspensionType {
+    Hardtail, // Тільки передня амортизація
+    Full      // Повна амортизація (передня і задня)
+};
+
+// Аеродинамічність (1-3)
+enum class AerodynamicsLevel {
+    Standard = 1, // Стандартна рама
+    SemiAero = 2, // Напіваеродинамічна
+    FullAero = 3  // Максимально аеродинамічна
+};
+
+//Типи замовлень
+enum class OrderType {
+    Standard,
+    FixedDiscount,
+    ProgressiveDiscount
+};
+
+// Характеристики велосипеда, які можна змінити після створення
+enum class BikeField {
+    FrameSize,
+    WheelSize,
+    GearCount,
+    Price
+};
+
+class Bike;
+
+// Спостерігач за змінами характеристик велосипеда (наприклад, індекси магазину)
+class BikeObserver {
+public:
+    virtual void onBikeChanged(const Bike &bike, BikeField field, double oldValue) = 0;
+
+    virtual ~BikeObserver() = default;
+};
+
+// Приймач готових сторінок звіту
+class ReportSink {
+public:
+    virtual void write(string_view page) = 0;
+
+    virtual ~ReportSink() = default;
+};
+
+// Потік (cout, ofstream): сторінка передається одним викликом write, без скидання буфера
+class StreamSink : public ReportSink {
+    ostream &stream;
+
+public:
+    explicit StreamSink(ostream &stream) : stream(stream) {}
+
+    void write(string_view page) override {
+        stream.write(page.data(), static_cast<streamsize>(page.size()));
+        if (!stream) throw runtime_error("Failed to write report to stream.");
+    }
+};
+
+// Файл C (stdout або відкритий fopen)
+class FileSink : public ReportSink {
+    FILE *file;
+
+public:
+    explicit FileSink(FILE *file) : file(file) {
+        if (!file) throw invalid_argument("File must not be null.");
+    }
+
+    void write(string_view page) override {
+        if (fwrite(page.data(), 1, page.size(), file) != page.size()) {
+            throw runtime_error("Failed to write report to file.");
+        }
+    }
+};
+
+// Файловий дескриптор: запис напряму системними викликами, по одному на сторінку
+class FdSink : public ReportSink {
+    int fd;
+
+public:
+    explicit FdSink(int fd) : fd(fd) {}
+
+    void write(string_view page) override {
+        while (!page.empty()) {
+#ifdef _WIN32
+            auto written = _write(fd, page.data(), static_cast<unsigned>(page.size()));
+#else
+            auto written = ::write(fd, page.data(), page.size());
+#endif
+            if (written < 0) throw runtime_error("Failed to write report to file descriptor.");
+            page.remove_prefix(static_cast<size_t>(written));
+        }
+    }
+};
+
+// Рядок у пам'яті (наприклад, частина експорту, яку форматує окремий потік)
+class StringSink : public ReportSink {
+    string &target;
+
+public:
+    explicit StringSink(string &target) : target(target) {}
+
+    void write(string_view page) override {
+        target.append(page);
+    }
+};
+
+// Форматування звітів у багаторазовий буфер; заповнена сторінка віддається приймачу одним записом,
+// тож пам'ять обмежена розміром сторінки навіть для дуже великих звітів
+// Числа з рухомою комою форматуються так само, як у ostream за замовчуванням (%g)
+class ReportWriter {
+    ReportSink &sink;
+    string buffer;
+    size_t pageSize;
+
+    void append(const char *data, size_t size) {
+        buffer.append(data, size);
+        if (buffer.size() >= pageSize) flush();
+    }
+
+public:
+    static constexpr size_t defaultPageSize = 64 * 1024;
+
+    explicit ReportWriter(ReportSink &sink, size_t pageSize = defaultPageSize)
+            : sink(sink), pageSize(max<size_t>(pageSize, 1)) {
+        buffer.reserve(this->pageSize + 256);
+    }
+
+    ReportWriter(const ReportWriter &) = delete;
+    ReportWriter &operator=(const ReportWriter &) = delete;
+
+    ~ReportWriter() {
+        try {
+            flush();
+        } catch (...) {
+            // Помилку запису вже неможливо повідомити з деструктора
+        }
+    }
+
+    void flush() {
+        if (buffer.empty()) return;
+        sink.write(buffer);
+        buffer.clear();
+    }
+
+    ReportWriter &operator<<(string_view text) {
+        append(text.data(), text.size());
+        return *this;
+    }
+
+    ReportWriter &operator<<(const char *text) {
+        return *this << string_view(text);
+    }
+
+    ReportWriter &operator<<(const string &text) {
+        return *this << string_view(text);
+    }
+
+    ReportWriter &operator<<(char c) {
+        append(&c, 1);
+        return *this;
+    }
+
+    template<typename T> requires is_integral_v<T>
+    ReportWriter &operator<<(T value) {
+        char digits[24];
+        auto result = to_chars(begin(digits), end(digits), value);
+        append(digits, result.ptr - digits);
+        return *this;
+    }
+
+    ReportWriter &operator<<(double value) {
+        char digits[32];
+        auto result = to_chars(begin(digits), end(digits), value, chars_format::general, 6);
+        append(digits, result.ptr - digits);
+        return *this;
+    }
+
+    // Найкоротше представлення, з якого число відновлюється точно (для експорту)
+    ReportWriter &exact(double value) {
+        char digits[32];
+        auto result = to_chars(begin(digits), end(digits), value);
+        append(digits, result.ptr - digits);
+        return *this;
+    }
+
+    // Поле CSV: у лапках, лише якщо містить кому, лапки або перенесення рядка
+    ReportWriter &csv(string_view field) {
+        if (field.find_first_of(",\"\r\n") == string_view::npos) return *this << field;
+        *this << '"';
+        for (char c: field) {
+            if (c == '"') *this << '"';
+            *this << c;
+        }
+        return *this << '"';
+    }
+
+    // Рядок JSON у лапках з екрануванням
+    ReportWriter &json(string_view text) {
+        static constexpr char hex[] = "0123456789abcdef";
+        auto plain = [](char c) { return c != '"' && c != '\\' && static_cast<unsigned char>(c) >= 0x20; };
+        if (all_of(text.begin(), text.end(), plain)) return *this << '"' << text << '"';
+        *this << '"';
+        for (char c: text) {
+            auto code = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                *this << '\\' << c;
+            } else if (code < 0x20) {
+                char escaped[] = {'\\', 'u', '0', '0', hex[code >> 4], hex[code & 0xF]};
+                append(escaped, sizeof(escaped));
+            } else {
+                *this << c;
+            }
+        }
+        return *this << '"';
+    }
+
+    [[nodiscard]] size_t getPageSize() const { return pageSize; }
+};
+
+// Абстрактний клас для велосипеда
+// Велосипед спільно належить інвентарю та рядкам замовлень, що на нього посилаються
+class Bike : public enable_shared_from_this<Bike> {
+protected:
+    string model;
+    double frameSize;
+    double wheelSize;
+    int gearCount;
+    BikeType type;
+    double price;
+    BikeObserver *observer = nullptr; // Не копіюється разом з велосипедом
+
+    void notify(BikeField field, double oldValue) {
+        if (observer) observer->onBikeChanged(*this, field, oldValue);
+    }
+
+public:
+    Bike(const string &model, double frameSize, double wheelSize, int gearCount, BikeType type, double price)
+            : model(model), frameSize(frameSize), wheelSize(wheelSize), gearCount(gearCount), type(type), price(price) {
+        if (model.empty()) throw invalid_argument("Model must not be empty.");
+        if (frameSize <= 0 || wheelSize <= 0 || gearCount <= 0 || price <= 0) {
+            throw invalid_argument("Frame size, wheel size, gear count, and totalPrice must be positive.");
+        }
+    }
+
+    Bike(Bike *bikecopy) : model(bikecopy->model), frameSize(bikecopy->frameSize), wheelSize(bikecopy->wheelSize),
+                           gearCount(bikecopy->gearCount), type(bikecopy->type), price(bikecopy->price) {
+
+    }
+
+    virtual ~Bike() = default;
+
+    virtual void render(ReportWriter &out) const = 0; // Абстрактний метод
+
+    void displayInfo() const {
+        StreamSink sink(cout);
+        ReportWriter out(sink);
+        render(out);
+    }
+
+    [[nodiscard]] double getPrice() const { return price; }
+
+    [[nodiscard]] const string &getModel() const { return model; }
+
+    [[nodiscard]] double getFrameSize() const { return frameSize; }
+
+    void setFrameSize(double frameSize) {
+        if (frameSize <= 0) {
+            throw invalid_argument("Frame size must be positive.");
+        }
+        double oldValue = this->frameSize;
+        this->frameSize = frameSize;
+        notify(BikeField::FrameSize, oldValue);
+    }
+
+    [[nodiscard]] double getWheelSize() const { return wheelSize; }
+
+    void setWheelSize(double wheelSize) {
+        if (wheelSize <= 0) {
+            throw invalid_argument("Wheel size must be positive.");
+        }
+        double oldValue = this->wheelSize;
+        this->wheelSize = wheelSize;
+        notify(BikeField::WheelSize, oldValue);
+    }
+
+    [[nodiscard]] int getGearCount() const { return gearCount; }
+
+    void setGearCount(int gearCount) {
+        if (gearCount <= 0) {
+            throw invalid_argument("Gear count must be positive.");
+        }
+        int oldValue = this->gearCount;
+        this->gearCount = gearCount;
+        notify(BikeField::GearCount, oldValue);
+    }
+
+    [[nodiscard]] BikeType getType() const { return type; }
+
+    void setPrice(double price) {
+        if (price <= 0) {
+            throw invalid_argument("Price must be positive.");
+        }
+        double oldValue = this->price;
+        this->price = price;
+        notify(BikeField::Price, oldValue);
+    }
+
+    void setObserver(BikeObserver *bikeObserver) {
+        observer = bikeObserver;
+    }
+
+    [[nodiscard]] virtual string toString() const {
+        stringstream os;
+        os << static_cast<int>(type) << " "
+           << model << " "
+           << frameSize << " "
+           << wheelSize << " "
+           << gearCount << " "
+           << price;
+        return os.str();
+    }
+
+    friend ostream &operator<<(ostream &os, const Bike &bike) {
+        os << bike.toString();
+        return os;
+    }
+
+};
+
+
+// Mountain Bike
+class MountainBike : public Bike {
+    string suspensionModel;
+    SuspensionType suspensionType;
+
+public:
+
+
+    ~MountainBike() override = default;
+
+    MountainBike(const string &model, double frameSize, double wheelSize, int gearCount, double price,
+                 const string &suspensionModel, SuspensionType suspensionType)
+            : Bike(model, frameSize, wheelSize, gearCount, BikeType::Mountain, price),
+              suspensionModel(suspensionModel), suspensionType(suspensionType) {
+        if (suspensionModel.empty()) {
+            throw invalid_argument("Suspension model cannot be empty.");
+        }
+    }
+
+    MountainBike(MountainBike *bikecopy) : Bike(bikecopy), suspensionType(bikecopy->suspensionType),
+                                           suspensionModel(bikecopy->suspensionModel) {}
+
+    [[nodiscard]] const string &getSuspensionModel() const { return suspensionModel; }
+
+    [[nodiscard]] SuspensionType getSuspensionType() const { return suspensionType; }
+
+    void render(ReportWriter &out) const override {
+        out << "Mountain Bike: " << model << ", Frame: " << frameSize << " inches, Wheel size: " << wheelSize
+            << " inches, Gear count: " << gearCount << ",  Suspension: " << suspensionModel
+            << " (" << (suspensionType == SuspensionType::Hardtail ? "Hardtail" : "Full")
+            << ")" << '\n' << "Price: $" << price << '\n';
+    }
+
+
+    [[nodiscard]] string toString() const override {
+        ostringstream os;
+        os << Bike::toString() << " " << suspensionModel << " " << static_cast<int>(suspensionType);
+        return os.str();
+    }
+};
+
+// Road Bike
+class RoadBike : public Bike {
+    AerodynamicsLevel aerodynamics;
+
+public:
+    ~RoadBike() override = default;
+
+    RoadBike(const string &model, double frameSize, double wheelSize, int gearCount, double price,
+             AerodynamicsLevel aerodynamics)
+            : Bike(model, frameSize, wheelSize, gearCount, BikeType::Road, price), aerodynamics(aerodynamics) {}
+
+    void render(ReportWriter &out) const override {
+        out << "Road Bike: " << model << ", Frame: " << frameSize << " inches, Wheel size: " << wheelSize
+            << " inches, Gear count: " << gearCount << ", Aerodynamics: "
+            << static_cast<int>(aerodynamics) << "/3" << '\n' << "Price: $" << price << '\n';
+    }
+
+    [[nodiscard]] string toString() const override {
+        ostringstream os;
+        os << Bike::toString() << " " << static_cast<int>(aerodynamics);
+        return os.str();
+    }
+
+    RoadBike(RoadBike *bikecopy) : Bike(bikecopy), aerodynamics(bikecopy->aerodynamics) {
+
+    }
+
+    [[nodiscard]] AerodynamicsLevel getAerodynamics() const { return aerodynamics; }
+};
+
+// Клас для позиції у замовленні
+class OrderItem {
+    shared_ptr<Bike> bike; // Утримує велосипед і після видалення його з інвентаря
+    int quantity;
+    double totalPrice;
+
+    // Велосипед інвентаря вже має власника; чужий велосипед рядок копіює собі
+    static shared_ptr<Bike> share(Bike *bike) {
+        if (!bike) return nullptr;
+        if (auto owned = bike->weak_from_this().lock()) return owned;
+        if (bike->getType() == BikeType::Mountain) {
+            return make_shared<MountainBike>(dynamic_cast<MountainBike *>(bike));
+        }
+        return make_shared<RoadBike>(dynamic_cast<RoadBike *>(bike));
+    }
+
+public:
+    OrderItem(shared_ptr<Bike> bike, int quantity = 1)
+            : bike(std::move(bike)), quantity(quantity) {
+        if (!this->bike) {
+            throw invalid_argument("Bike must not be null");
+        }
+        if (quantity <= 0) {
+            throw invalid_argument("Quantity must be positive.");
+        }
+        this->totalPrice = this->bike->getPrice() * quantity;
+    }
+
+    OrderItem(Bike *bike, int quantity = 1) : OrderItem(share(bike), quantity) {}
+
+    [[nodiscard]] double getTotalPrice() const { return totalPrice; }
+
+    [[nodiscard]] int getQuantity() const { return quantity; }
+
+    [[nodiscard]] Bike *getBike() const { return bike.get(); }
+
+    // Кількість власників велосипеда: інвентар і рядки замовлень
+    [[nodiscard]] long getBikeOwners() const { return bike.use_count(); }
+
+    friend ostream &operator<<(ostream &os, const OrderItem &item) {
+        os << *item.bike << " " << item.quantity;
+        return os;
+    }
+
+};
+
+// Інтерфейс IOrder
+class IOrder {
+public:
+    [[nodiscard]] virtual double calculateTotalPrice() const = 0;
+
+    virtual ~IOrder() = default;
+};
+
+// Базовий клас замовлення
+class Order : public IOrder {
+protected:
+    vector<OrderItem> items;
+    string user;
+    OrderType type;
+    long long soldAt = 0; // Час продажу (секунди Unix), 0 - ще не відправлене
+
+public:
+    ~Order() override = default;
+
+    // Позиції переміщуються у замовлення без копіювання
+    Order(const string &user, vector<OrderItem> &&items, OrderType type = OrderType::Standard)
+            : items(std::move(items)), user(user), type(type) {
+        if (user.empty()) {
+            throw invalid_argument("User name cannot be empty.");
+        }
+    }
+
+    Order(const Order &) = delete;
+
+    Order &operator=(const Order &) = delete;
+
+    void addItem(const OrderItem &item) { items.push_back(item); }
+
+    // Переміщення позиції не змінює лічильник власників велосипеда
+    void addItem(OrderItem &&item) { items.push_back(std::move(item)); }
+
+    [[nodiscard]] double calculateTotalPrice() const override {
+        double total = 0;
+        for (const auto &item: items) {
+            total += item.getTotalPrice();
+        }
+        return total;
+    }
+
+    // Вартість позицій без урахування знижок
+    [[nodiscard]] double getSubtotal() const {
+        return Order::calculateTotalPrice();
+    }
+
+    [[nodiscard]] span<const OrderItem> getItems() const {
+        return items;
+    }
+
+    // Пам'ять масиву позицій за його місткістю
+    [[nodiscard]] size_t itemsMemoryBytes() const {
+        return items.capacity() * sizeof(OrderItem);
+    }
+
+    [[nodiscard]] const string &getUser() const {
+        return user;
+    }
+
+    void render(ReportWriter &out) const {
+        out << "Customer: " << user << '\n';
+        out << "Total Price: " << calculateTotalPrice() << '\n';
+        out << "Items in the Order:" << '\n';
+        for (const auto &item: items) {
+            item.getBike()->render(out);
+            out << "Quantity: " << item.getQuantity() << '\n';
+            out << "-----------------------------" << '\n';
+        }
+    }
+
+    void displayOrderInfo() const {
+        StreamSink sink(cout);
+        ReportWriter out(sink);
+        render(out);
+    }
+
+    [[nodiscard]] virtual string toString() const {
+        stringstream os;
+        os << static_cast<int>(type) << " " << soldAt << " " << user << " " << items.size() << " ";
+        for (auto &item: items) {
+            os << item << " ";
+        }
+        return os.str();
+    }
+
+    [[nodiscard]] long long getSoldAt() const {
+        return soldAt;
+    }
+
+    void setSoldAt(long long timestamp) {
+        if (timestamp < 0) throw invalid_argument("Timestamp must not be negative.");
+        soldAt = timestamp;
+    }
+
+    [[nodiscard]] int getTotalItems() const {
+        int total = 0;
+        for (auto &item: items) {
+            total += item.getQuantity();
+        }
+        return total;
+    }
+
+    friend ostream &operator<<(ostream &os, const Order &order) {
+        os << order.toString();
+        return os;
+    }
+
+    [[nodiscard]] OrderType getType() const {
+        return type;
+    }
+};
+
+// Замовлення з прогресивною знижкою
+class ProgressiveDiscountOrder : public Order {
+
+    [[nodiscard]] double calculateDiscount(double sum) const {
+        if (sum > 7000) return sum * 0.2;
+        if (sum > 3000) return sum * 0.1;
+        return 0;
+    }
+
+public:
+
+    ProgressiveDiscountOrder(const string &user, vector<OrderItem> &&items)
+            : Order(user, std::move(items), OrderType::ProgressiveDiscount) {};
+
+    [[nodiscard]] double calculateTotalPrice() const override {
+        double total = Order::calculateTotalPrice();
+        return total - calculateDiscount(total);
+    }
+
+    friend ostream &operator<<(ostream &os, const ProgressiveDiscountOrder &order) {
+        os << order.toString();
+        return os;
+    }
+};
+
+class FixedDiscountOrder : public Order {
+    float discount;
+
+    double calculateDiscount(double sum) const {
+        return sum * discount / 100;
+    }
+
+public:
+    FixedDiscountOrder(const string &user, vector<OrderItem> &&items, float discount = 0)
+            : Order(user, std::move(items), OrderType::FixedDiscount), discount(discount) {
+        if (discount < 0 || discount > 100) throw invalid_argument("Discount is out of adequate range(0-100)");
+    }
+
+    [[nodiscard]] double calculateTotalPrice() const override {
+        double total = Order::calculateTotalPrice();
+        return total - calculateDiscount(total);
+    }
+
+    [[nodiscard]] string toString() const override {
+        stringstream os;
+        os << Order::toString() << discount;
+        return os.str();
+    }
+
+    friend ostream &operator<<(ostream &os, const FixedDiscountOrder &order) {
+        os << order.toString();
+        return os;
+    }
+};
+
+// Оцінки пам'яті в купі за фактичною місткістю контейнерів, без службових даних аллокатора
+// Рядок займає купу лише тоді, коли не вміщується у вбудований буфер короткого рядка
+inline size_t heapBytes(const string &text) {
+    static const size_t inlineCapacity = string().capacity();
+    return text.capacity() > inlineCapacity ? text.capacity() + 1 : 0;
+}
+
+template<typename T>
+size_t heapBytes(const vector<T> &values) {
+    return values.capacity() * sizeof(T);
+}
+
+// Вузли map/set: колір і три вказівники перед значенням (без купи всередині значень)
+template<typename Tree>
+size_t treeBytes(const Tree &tree) {
+    return tree.size() * (4 * sizeof(void *) + sizeof(typename Tree::value_type));
+}
+
+// Вузли unordered_map (вказівник на наступний, значення, збережений хеш) і масив кошиків
+template<typename Table>
+size_t tableBytes(const Table &table) {
+    return table.size() * (2 * sizeof(void *) + sizeof(typename Table::value_type)) +
+           table.bucket_count() * sizeof(void *);
+}
+
+// Список моделей, запас яких опустився нижче точки дозамовлення
+// Зберігаються лише такі моделі, впорядковані за запасом відносно порогу: кожне оновлення O(log n)
+class LowStockWatch {
+    set<pair<int, string>> low; // (запас - поріг, модель), лише для від'ємних значень
+    function<void(const string &model, int quantity, int reorderPoint)> onLow;
+
+public:
+    // Запас відносно порогу змінився з oldHeadroom на newHeadroom
+    void update(const string &model, int oldHeadroom, int newHeadroom, int reorderPoint) {
+        if (oldHeadroom == newHeadroom) return;
+        if (oldHeadroom < 0) low.erase({oldHeadroom, model});
+        if (newHeadroom < 0) {
+            low.emplace(newHeadroom, model);
+            if (oldHeadroom >= 0 && onLow) onLow(model, newHeadroom + reorderPoint, reorderPoint);
+        }
+    }
+
+    void forget(const string &model, int headroom) {
+        if (headroom < 0) low.erase({headroom, model});
+    }
+
+    void clear() {
+        low.clear();
+    }
+
+    void setCallback(function<void(const string &model, int quantity, int reorderPoint)> callback) {
+        onLow = std::move(callback);
+    }
+
+    // Моделі з нестачею, починаючи з найбільшої
+    [[nodiscard]] vector<string> models() const {
+        vector<string> result;
+        result.reserve(low.size());
+        for (const auto &entry: low) {
+            result.push_back(entry.second);
+        }
+        return result;
+    }
+
+    [[nodiscard]] size_t size() const { return low.size(); }
+
+    [[nodiscard]] size_t memoryBytes() const {
+        size_t bytes = treeBytes(low);
+        for (const auto &entry: low) bytes += heapBytes(entry.second);
+        return bytes;
+    }
+};
+
+class InventoryItem {
+    shared_ptr<Bike> bike;
+    int quantity;
+    int reserved = 0;     // Кількість, утримувана для кошиків покупців
+    int reorderPoint = 0; // Поріг дозамовлення
+    LowStockWatch *watch; // Спостерігач за нестачею (може бути відсутній)
+    uint32_t sku = 0;     // Незмінний ідентифікатор позиції в інвентарі
+
+    void notify(int oldHeadroom) {
+        if (watch) watch->update(bike->getModel(), oldHeadroom, getHeadroom(), reorderPoint);
+    }
+
+public:
+    InventoryItem(shared_ptr<Bike> bike, int quantity, LowStockWatch *watch = nullptr)
+            : bike(std::move(bike)), quantity(quantity), watch(watch) {
+        if (quantity < 0) throw invalid_argument("Quantity must be positive or 0");
+        if (!this->bike) throw invalid_argument("Bike can't but null");
+    }
+
+    [[nodiscard]] Bike *getBike() const {
+        return bike.get();
+    }
+
+    [[nodiscard]] int getQuantity() const {
+        return quantity;
+    }
+
+    [[nodiscard]] uint32_t getSku() const {
+        return sku;
+    }
+
+    void setSku(uint32_t id) {
+        sku = id;
+    }
+
+    void increaseQuantity(int number) {
+        if (number <= 0) throw invalid_argument("Number must be positive");
+        int oldHeadroom = getHeadroom();
+        quantity += number;
+        notify(oldHeadroom);
+    }
+
+    void decreaseQuantity(int number) {
+        if (number <= 0) throw invalid_argument("Number must be positive");
+        int oldHeadroom = getHeadroom();
+        quantity -= number;
+        notify(oldHeadroom);
+    }
+
+    [[nodiscard]] int getReorderPoint() const {
+        return reorderPoint;
+    }
+
+    void setReorderPoint(int point) {
+        if (point < 0) throw invalid_argument("Reorder point must be positive or 0");
+        int oldHeadroom = getHeadroom();
+        reorderPoint = point;
+        notify(oldHeadroom);
+    }
+
+    // Запас відносно порогу; від'ємне значення означає нестачу
+    [[nodiscard]] int getHeadroom() const {
+        return quantity - reorderPoint;
+    }
+
+    [[nodiscard]] int getReserved() const {
+        return reserved;
+    }
+
+    // Доступна кількість = запас - утримане
+    [[nodiscard]] int getAvailable() const {
+        return quantity - reserved;
+    }
+
+    void reserve(int number) {
+        if (number <= 0) throw invalid_argument("Number must be positive");
+        if (number > getAvailable()) throw runtime_error("Not enough available stock to reserve.");
+        reserved += number;
+    }
+
+    void release(int number) {
+        if (number <= 0) throw invalid_argument("Number must be positive");
+        reserved -= min(number, reserved);
+    }
+};
+
+// Стиснена множина 32-бітних чисел у стилі Roaring:
+// старші 16 біт вибирають контейнер, молодші зберігаються у ньому
+// масивом (до 4096 значень) або бітовою картою з 65536 біт
+class RoaringBitmap {
+    struct Container {
+        static constexpr size_t arrayLimit = 4096;
+        static constexpr size_t words = 1024;
+
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        vector<uint16_t> values; // Впорядковані значення, якщо контейнер-масив
+        vector<uint64_t> bits;   // Бітова карта, якщо контейнер великий
+
+        [[nodiscard]] bool isBitmap() const { return !bits.empty(); }
+
+        [[nodiscard]] bool contains(uint16_t low) const {
+            if (isBitmap()) return (bits[low >> 6] >> (low & 63)) & 1;
+            return binary_search(values.begin(), values.end(), low);
+        }
+
+        void toBitmap() {
+            bits.assign(words, 0);
+            for (uint16_t low: values) {
+                bits[low >> 6] |= uint64_t(1) << (low & 63);
+            }
+            values.clear();
+            values.shrink_to_fit();
+        }
+
+        void toArray() {
+            values.clear();
+            values.reserve(cardinality);
+            forEach([&](uint16_t low) { values.push_back(low); });
+            bits.clear();
+            bits.shrink_to_fit();
+        }
+
+        // Вибір представлення за кількістю значень
+        void normalize() {
+            if (isBitmap() && cardinality <= arrayLimit) toArray();
+            else if (!isBitmap() && cardinality > arrayLimit) toBitmap();
+        }
+
+        // Підрахунок бітів без бібліотечного popcount, який без -mpopcnt викликається як повільна функція
+        static uint64_t countBits(uint64_t word) {
+            word = word - ((word >> 1) & 0x5555555555555555ULL);
+            word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+            word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return (word * 0x0101010101010101ULL) >> 56;
+        }
+
+        void recount() {
+            uint64_t total = 0;
+            for (uint64_t word: bits) {
+                total += countBits(word);
+            }
+            cardinality = static_cast<uint32_t>(total);
+        }
+
+        // Перетин двох бітових карт на місці з підрахунком за один прохід
+        void intersectBits(const Container &other) {
+            uint64_t total = 0;
+            for (size_t i = 0; i < words; ++i) {
+                bits[i] &= other.bits[i];
+                total += countBits(bits[i]);
+            }
+            cardinality = static_cast<uint32_t>(total);
+            normalize();
+        }
+
+        bool add(uint16_t low) {
+            if (isBitmap()) {
+                uint64_t &word = bits[low >> 6];
+                uint64_t mask = uint64_t(1) << (low & 63);
+                if (word & mask) return false;
+                word |= mask;
+            } else {
+                auto it = lower_bound(values.begin(), values.end(), low);
+                if (it != values.end() && *it == low) return false;
+                values.insert(it, low);
+            }
+            ++cardinality;
+            normalize();
+            return true;
+        }
+
+        bool remove(uint16_t low) {
+            if (isBitmap()) {
+                uint64_t &word = bits[low >> 6];
+                uint64_t mask = uint64_t(1) << (low & 63);
+                if (!(word & mask)) return false;
+                word &= ~mask;
+            } else {
+                auto it = lower_bound(values.begin(), values.end(), low);
+                if (it == values.end() || *it != low) return false;
+                values.erase(it);
+            }
+            --cardinality;
+            normalize();
+            return true;
+        }
+
+        template<typename F>
+        void forEach(F action) const {
+            if (!isBitmap()) {
+                for (uint16_t low: values) action(low);
+                return;
+            }
+            for (size_t i = 0; i < words; ++i) {
+                for (uint64_t word = bits[i]; word; word &= word - 1) {
+                    action(static_cast<uint16_t>(i * 64 + countr_zero(word)));
+                }
+            }
+        }
+
+        static Container intersect(const Container &a, const Container &b) {
+            Container result;
+            result.key = a.key;
+            if (a.isBitmap() && b.isBitmap()) {
+                result.bits.resize(words);
+                for (size_t i = 0; i < words; ++i) result.bits[i] = a.bits[i] & b.bits[i];
+                result.recount();
+            } else {
+                const Container &small = a.isBitmap() ? b : a;
+                const Container &other = a.isBitmap() ? a : b;
+                for (uint16_t low: small.values) {
+                    if (other.contains(low)) result.values.push_back(low);
+                }
+                result.cardinality = static_cast<uint32_t>(result.values.size());
+            }
+            result.normalize();
+            return result;
+        }
+
+        static Container unite(const Container &a, const Container &b) {
+            Container result;
+            result.key = a.key;
+            if (a.isBitmap() || b.isBitmap()) {
+                result.bits = a.isBitmap() ? a.bits : b.bits;
+                const Container &other = a.isBitmap() ? b : a;
+                if (other.isBitmap()) {
+                    for (size_t i = 0; i < words; ++i) result.bits[i] |= other.bits[i];
+                } else {
+                    for (uint16_t low: other.values) result.bits[low >> 6] |= uint64_t(1) << (low & 63);
+                }
+                result.recount();
+            } else {
+                result.values.reserve(a.values.size() + b.values.size());
+                set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                          back_inserter(result.values));
+                result.cardinality = static_cast<uint32_t>(result.values.size());
+            }
+            result.normalize();
+            return result;
+        }
+
+        static Container subtract(const Container &a, const Container &b) {
+            Container result;
+            result.key = a.key;
+            if (a.isBitmap()) {
+                result.bits = a.bits;
+                if (b.isBitmap()) {
+                    for (size_t i = 0; i < words; ++i) result.bits[i] &= ~b.bits[i];
+                } else {
+                    for (uint16_t low: b.values) result.bits[low >> 6] &= ~(uint64_t(1) << (low & 63));
+                }
+                result.recount();
+            } else {
+                for (uint16_t low: a.values) {
+                    if (!b.contains(low)) result.values.push_back(low);
+                }
+                result.cardinality = static_cast<uint32_t>(result.values.size());
+            }
+            result.normalize();
+            return result;
+        }
+    };
+
+    vector<Container> containers; // Впорядковані за ключем
+
+    [[nodiscard]] vector<Container>::const_iterator findContainer(uint16_t key) const {
+        return lower_bound(containers.begin(), containers.end(), key,
+                           [](const Container &c, uint16_t k) { return c.key < k; });
+    }
+
+    vector<Container>::iterator findContainer(uint16_t key) {
+        return lower_bound(containers.begin(), containers.end(), key,
+                           [](const Container &c, uint16_t k) { return c.key < k; });
+    }
+
+public:
+    // Побудова з невпорядкованих значень: великі контейнери заповнюються бітами без сортування
+    static RoaringBitmap fromValues(const vector<uint32_t> &values) {
+        RoaringBitmap result;
+        if (values.empty()) return result;
+        uint32_t maxValue = *max_element(values.begin(), values.end());
+        vector<vector<uint16_t>> buckets((maxValue >> 16) + 1);
+        for (uint32_t value: values) {
+            buckets[value >> 16].push_back(static_cast<uint16_t>(value));
+        }
+        for (size_t key = 0; key < buckets.size(); ++key) {
+            auto &lows = buckets[key];
+            if (lows.empty()) continue;
+            Container c;
+            c.key = static_cast<uint16_t>(key);
+            if (lows.size() > Container::arrayLimit) {
+                c.bits.assign(Container::words, 0);
+                for (uint16_t low: lows) c.bits[low >> 6] |= uint64_t(1) << (low & 63);
+                c.recount();
+                c.normalize();
+            } else {
+                sort(lows.begin(), lows.end());
+                lows.erase(unique(lows.begin(), lows.end()), lows.end());
+                c.cardinality = static_cast<uint32_t>(lows.size());
+                c.values = std::move(lows);
+            }
+            result.containers.push_back(std::move(c));
+        }
+        return result;
+    }
+
+    bool add(uint32_t value) {
+        auto key = static_cast<uint16_t>(value >> 16);
+        auto it = findContainer(key);
+        if (it == containers.end() || it->key != key) {
+            it = containers.insert(it, Container());
+            it->key = key;
+        }
+        return it->add(static_cast<uint16_t>(value));
+    }
+
+    bool remove(uint32_t value) {
+        auto key = static_cast<uint16_t>(value >> 16);
+        auto it = findContainer(key);
+        if (it == containers.end() || it->key != key) return false;
+        bool removed = it->remove(static_cast<uint16_t>(value));
+        if (it->cardinality == 0) containers.erase(it);
+        return removed;
+    }
+
+    void set(uint32_t value, bool present) {
+        if (present) add(value);
+        else remove(value);
+    }
+
+    [[nodiscard]] bool contains(uint32_t value) const {
+        auto key = static_cast<uint16_t>(value >> 16);
+        auto it = findContainer(key);
+        return it != containers.end() && it->key == key && it->contains(static_cast<uint16_t>(value));
+    }
+
+    [[nodiscard]] size_t cardinality() const {
+        size_t total = 0;
+        for (const auto &c: containers) total += c.cardinality;
+        return total;
+    }
+
+    [[nodiscard]] bool empty() const { return containers.empty(); }
+
+    void clear() { containers.clear(); }
+
+    // Обхід значень у порядку зростання
+    template<typename F>
+    void forEach(F action) const {
+        for (const auto &c: containers) {
+            uint32_t high = uint32_t(c.key) << 16;
+            c.forEach([&](uint16_t low) { action(high | low); });
+        }
+    }
+
+    [[nodiscard]] vector<uint32_t> toVector() const {
+        vector<uint32_t> result;
+        result.reserve(cardinality());
+        forEach([&](uint32_t value) { result.push_back(value); });
+        return result;
+    }
+
+    // Перетин виконується на місці, без копіювання великих контейнерів
+    RoaringBitmap &operator&=(const RoaringBitmap &other) {
+        size_t kept = 0;
+        auto b = other.containers.begin();
+        for (auto &c: containers) {
+            while (b != other.containers.end() && b->key < c.key) ++b;
+            if (b == other.containers.end()) break;
+            if (b->key != c.key) continue;
+            if (c.isBitmap() && b->isBitmap()) {
+                c.intersectBits(*b);
+            } else {
+                c = Container::intersect(c, *b);
+            }
+            if (!c.cardinality) continue;
+            if (&containers[kept] != &c) containers[kept] = std::move(c);
+            ++kept;
+        }
+        containers.resize(kept);
+        return *this;
+    }
+
+    RoaringBitmap &operator|=(const RoaringBitmap &other) {
+        vector<Container> result;
+        result.reserve(containers.size() + other.containers.size());
+        auto a = containers.begin();
+        auto b = other.containers.begin();
+        while (a != containers.end() || b != other.containers.end()) {
+            if (b == other.containers.end() || (a != containers.end() && a->key < b->key)) {
+                result.push_back(std::move(*a++));
+            }
+            else if (a == containers.end() || b->key < a->key) result.push_back(*b++);
+            else result.push_back(Container::unite(*a++, *b++));
+        }
+        containers = std::move(result);
+        return *this;
+    }
+
+    // Різниця множин (AND NOT)
+    RoaringBitmap &operator-=(const RoaringBitmap &other) {
+        vector<Container> result;
+        auto b = other.containers.begin();
+        for (auto &c: containers) {
+            while (b != other.containers.end() && b->key < c.key) ++b;
+            if (b != other.containers.end() && b->key == c.key) {
+                Container diff = Container::subtract(c, *b);
+                if (diff.cardinality) result.push_back(std::move(diff));
+            } else {
+                result.push_back(std::move(c));
+            }
+        }
+        containers = std::move(result);
+        return *this;
+    }
+
+    friend RoaringBitmap operator&(RoaringBitmap a, const RoaringBitmap &b) { return a &= b; }
+
+    friend RoaringBitmap operator|(RoaringBitmap a, const RoaringBitmap &b) { return a |= b; }
+
+    friend RoaringBitmap operator-(RoaringBitmap a, const RoaringBitmap &b) { return a -= b; }
+
+    [[nodiscard]] size_t memoryBytes() const {
+        size_t bytes = heapBytes(containers);
+        for (const auto &c: containers) bytes += heapBytes(c.values) + heapBytes(c.bits);
+        return bytes;
+    }
+};
+
+// Впорядкований індекс (значення, SKU) для запитів за діапазоном
+// Основна частина - відсортований масив; зміни накопичуються у невеликих впорядкованих буферах
+// і періодично зливаються з ним, тому запит коштує O(log n + розмір результату)
+class RangeIndex {
+    using Entry = pair<double, uint32_t>;
+
+    vector<Entry> sorted;
+    set<Entry> added;   // Нові записи, ще не злиті з масивом
+    set<Entry> removed; // Видалені записи, що ще лишаються у масиві
+
+    void rebuild() {
+        vector<Entry> merged;
+        merged.reserve(sorted.size() + added.size() - removed.size());
+        auto pending = added.begin();
+        for (const auto &entry: sorted) {
+            if (removed.count(entry)) continue;
+            while (pending != added.end() && *pending < entry) merged.push_back(*pending++);
+            merged.push_back(entry);
+        }
+        merged.insert(merged.end(), pending, added.end());
+        sorted = std::move(merged);
+        added.clear();
+        removed.clear();
+    }
+
+    void maybeRebuild() {
+        if (added.size() + removed.size() > max<size_t>(1024, sorted.size() / 16)) rebuild();
+    }
+
+public:
+    void insert(double value, uint32_t sku) {
+        if (!removed.erase({value, sku})) added.emplace(value, sku);
+        maybeRebuild();
+    }
+
+    void erase(double value, uint32_t sku) {
+        if (!added.erase({value, sku})) removed.emplace(value, sku);
+        maybeRebuild();
+    }
+
+    void update(uint32_t sku, double oldValue, double newValue) {
+        erase(oldValue, sku);
+        insert(newValue, sku);
+    }
+
+    void clear() {
+        sorted.clear();
+        added.clear();
+        removed.clear();
+    }
+
+    // Обхід SKU зі значеннями у [low, high] за зростанням значення
+    template<typename F>
+    void forEachInRange(double low, double high, F action) const {
+        auto it = lower_bound(sorted.begin(), sorted.end(), Entry{low, 0});
+        auto pending = added.lower_bound({low, 0});
+        auto tombstone = removed.lower_bound({low, 0}); // Видалені йдуть у тому ж порядку, що й масив
+        while (true) {
+            bool fromSorted = it != sorted.end() && it->first <= high;
+            bool fromPending = pending != added.end() && pending->first <= high;
+            if (!fromSorted && !fromPending) break;
+            if (fromSorted && (!fromPending || *it < *pending)) {
+                while (tombstone != removed.end() && *tombstone < *it) ++tombstone;
+                if (tombstone == removed.end() || *tombstone != *it) action(it->second);
+                ++it;
+            } else {
+                action(pending->second);
+                ++pending;
+            }
+        }
+    }
+
+    [[nodiscard]] RoaringBitmap range(double low, double high) const {
+        vector<uint32_t> skus;
+        forEachInRange(low, high, [&](uint32_t sku) { skus.push_back(sku); });
+        return RoaringBitmap::fromValues(skus);
+    }
+
+    [[nodiscard]] size_t memoryBytes() const {
+        return heapBytes(sorted) + treeBytes(added) + treeBytes(removed);
+    }
+};
+
+// Фільтр каталогу: значення одного атрибута об'єднуються (OR), різні атрибути перетинаються (AND)
+// Порожній список означає, що атрибут не обмежується
+struct CatalogFilter {
+    vector<BikeType> types;
+    vector<SuspensionType> suspensions;
+    vector<AerodynamicsLevel> aerodynamics;
+    vector<int> gearCounts;
+    vector<double> wheelSizes;
+    optional<pair<double, double>> priceRange;     // Включні межі [від, до]
+    optional<pair<double, double>> frameSizeRange;
+    optional<pair<double, double>> wheelSizeRange;
+    bool inStockOnly = false;
+};
+
+// Бітові індекси каталогу за атрибутами з малою кількістю значень; біти - це SKU позицій інвентарю
+class CatalogIndex {
+    RoaringBitmap all;
+    RoaringBitmap inStock;
+    array<RoaringBitmap, 2> byType;
+    array<RoaringBitmap, 2> bySuspension;
+    array<RoaringBitmap, 3> byAerodynamics;
+    map<int, RoaringBitmap> byGearCount;
+    map<double, RoaringBitmap> byWheelSize;
+    RangeIndex priceRange;
+    RangeIndex frameSizeRange;
+    RangeIndex wheelSizeRange;
+
+    static const RoaringBitmap &emptyBitmap() {
+        static const RoaringBitmap empty;
+        return empty;
+    }
+
+    template<typename Key>
+    static void unset(map<Key, RoaringBitmap> &index, Key key, uint32_t sku) {
+        auto it = index.find(key);
+        if (it == index.end()) return;
+        it->second.remove(sku);
+        if (it->second.empty()) index.erase(it);
+    }
+
+    template<typename Values, typename Lookup>
+    static void restrict(RoaringBitmap &result, const Values &values, Lookup lookup) {
+        if (values.empty()) return;
+        if (values.size() == 1) {
+            result &= lookup(values.front());
+            return;
+        }
+        RoaringBitmap any;
+        for (const auto &value: values) any |= lookup(value);
+        result &= any;
+    }
+
+public:
+    void add(uint32_t sku, const Bike &bike, bool available) {
+        all.add(sku);
+        inStock.set(sku, available);
+        byType[static_cast<size_t>(bike.getType())].add(sku);
+        if (auto mountain = dynamic_cast<const MountainBike *>(&bike)) {
+            bySuspension[static_cast<size_t>(mountain->getSuspensionType())].add(sku);
+        } else if (auto road = dynamic_cast<const RoadBike *>(&bike)) {
+            byAerodynamics[static_cast<size_t>(road->getAerodynamics()) - 1].add(sku);
+        }
+        byGearCount[bike.getGearCount()].add(sku);
+        byWheelSize[bike.getWheelSize()].add(sku);
+        priceRange.insert(bike.getPrice(), sku);
+        frameSizeRange.insert(bike.getFrameSize(), sku);
+        wheelSizeRange.insert(bike.getWheelSize(), sku);
+    }
+
+    void remove(uint32_t sku, const Bike &bike) {
+        all.remove(sku);
+        inStock.remove(sku);
+        for (auto &bitmap: byType) bitmap.remove(sku);
+        for (auto &bitmap: bySuspension) bitmap.remove(sku);
+        for (auto &bitmap: byAerodynamics) bitmap.remove(sku);
+        unset(byGearCount, bike.getGearCount(), sku);
+        unset(byWheelSize, bike.getWheelSize(), sku);
+        priceRange.erase(bike.getPrice(), sku);
+        frameSizeRange.erase(bike.getFrameSize(), sku);
+        wheelSizeRange.erase(bike.getWheelSize(), sku);
+    }
+
+    void setInStock(uint32_t sku, bool available) {
+        inStock.set(sku, available);
+    }
+
+    // Оновлення індексів після зміни характеристики велосипеда
+    void update(uint32_t sku, const Bike &bike, BikeField field, double oldValue) {
+        switch (field) {
+            case BikeField::FrameSize:
+                frameSizeRange.update(sku, oldValue, bike.getFrameSize());
+                break;
+            case BikeField::WheelSize:
+                unset(byWheelSize, oldValue, sku);
+                byWheelSize[bike.getWheelSize()].add(sku);
+                wheelSizeRange.update(sku, oldValue, bike.getWheelSize());
+                break;
+            case BikeField::GearCount:
+                unset(byGearCount, static_cast<int>(oldValue), sku);
+                byGearCount[bike.getGearCount()].add(sku);
+                break;
+            case BikeField::Price:
+                priceRange.update(sku, oldValue, bike.getPrice());
+                break;
+        }
+    }
+
+    void clear() {
+        *this = CatalogIndex();
+    }
+
+    [[nodiscard]] RoaringBitmap query(const CatalogFilter &filter) const {
+        RoaringBitmap result = filter.inStockOnly ? inStock : all;
+        restrict(result, filter.types, [&](BikeType t) -> const RoaringBitmap & { return typeBitmap(t); });
+        restrict(result, filter.suspensions,
+                 [&](SuspensionType t) -> const RoaringBitmap & { return suspensionBitmap(t); });
+        restrict(result, filter.aerodynamics,
+                 [&](AerodynamicsLevel a) -> const RoaringBitmap & { return aerodynamicsBitmap(a); });
+        restrict(result, filter.gearCounts, [&](int g) -> const RoaringBitmap & { return gearCountBitmap(g); });
+        restrict(result, filter.wheelSizes,
+                 [&](double w) -> const RoaringBitmap & { return wheelSizeBitmap(w); });
+        if (filter.priceRange) result &= priceRange.range(filter.priceRange->first, filter.priceRange->second);
+        if (filter.frameSizeRange) {
+            result &= frameSizeRange.range(filter.frameSizeRange->first, filter.frameSizeRange->second);
+        }
+        if (filter.wheelSizeRange) {
+            result &= wheelSizeRange.range(filter.wheelSizeRange->first, filter.wheelSizeRange->second);
+        }
+        return result;
+    }
+
+    // Окремі бітові карти для довільних комбінацій AND/OR/NOT
+    [[nodiscard]] const RoaringBitmap &allBitmap() const { return all; }
+
+    [[nodiscard]] const RoaringBitmap &inStockBitmap() const { return inStock; }
+
+    [[nodiscard]] const RoaringBitmap &typeBitmap(BikeType type) const {
+        return byType[static_cast<size_t>(type)];
+    }
+
+    [[nodiscard]] const RoaringBitmap &suspensionBitmap(SuspensionType type) const {
+        return bySuspension[static_cast<size_t>(type)];
+    }
+
+    [[nodiscard]] const RoaringBitmap &aerodynamicsBitmap(AerodynamicsLevel level) const {
+        return byAerodynamics[static_cast<size_t>(level) - 1];
+    }
+
+    [[nodiscard]] const RoaringBitmap &gearCountBitmap(int gearCount) const {
+        auto it = byGearCount.find(gearCount);
+        return it == byGearCount.end() ? emptyBitmap() : it->second;
+    }
+
+    [[nodiscard]] const RoaringBitmap &wheelSizeBitmap(double wheelSize) const {
+        auto it = byWheelSize.find(wheelSize);
+        return it == byWheelSize.end() ? emptyBitmap() : it->second;
+    }
+
+    [[nodiscard]] const RangeIndex &priceIndex() const { return priceRange; }
+
+    [[nodiscard]] const RangeIndex &frameSizeIndex() const { return frameSizeRange; }
+
+    [[nodiscard]] const RangeIndex &wheelSizeIndex() const { return wheelSizeRange; }
+
+    [[nodiscard]] size_t memoryBytes() const {
+        size_t bytes = all.memoryBytes() + inStock.memoryBytes() + treeBytes(byGearCount) + treeBytes(byWheelSize) +
+                       priceRange.memoryBytes() + frameSizeRange.memoryBytes() + wheelSizeRange.memoryBytes();
+        for (const auto &bitmap: byType) bytes += bitmap.memoryBytes();
+        for (const auto &bitmap: bySuspension) bytes += bitmap.memoryBytes();
+        for (const auto &bitmap: byAerodynamics) bytes += bitmap.memoryBytes();
+        for (const auto &[gears, bitmap]: byGearCount) bytes += bitmap.memoryBytes();
+        for (const auto &[wheel, bitmap]: byWheelSize) bytes += bitmap.memoryBytes();
+        return bytes;
+    }
+};
+
+// Критерій впорядкування підказок автодоповнення
+enum class CompletionRank {
+    Stock,
+    Sales
+};
+
+// Словник назв моделей для автодоповнення
+// Назви зберігаються відсортованими блоками з фронтальним кодуванням: перший рядок блоку повністю,
+// решта - як довжина спільного з попереднім префікса і суфікс. Над блоками побудовано дерева максимумів
+// оцінок (запас, продажі), тож топ-k шукається від найкращих блоків і не декодує весь діапазон префікса.
+// Нові і видалені назви накопичуються окремо і періодично зливаються з закодованою частиною
+class ModelNameIndex {
+public:
+    using Scorer = function<double(CompletionRank rank, uint32_t sku, string_view name)>;
+
+private:
+    static constexpr size_t blockSize = 16;
+    static constexpr uint32_t noBlock = UINT32_MAX;
+    static constexpr size_t rankCount = 2;
+
+    string data;                   // Закодовані блоки
+    vector<uint32_t> blockOffsets; // Початок кожного блоку в data
+    size_t encodedCount = 0;
+    vector<uint32_t> blockOfSku;   // SKU -> номер блоку з його назвою
+    size_t treeSize = 1;           // Кількість листків дерева (степінь двійки)
+    array<vector<float>, rankCount> trees; // Максимуми оцінок: листки - блоки
+    map<string, uint32_t> added;   // Нові назви (назва -> SKU), ще не закодовані
+    set<string> removed;           // Закодовані назви, які вже видалені
+    Scorer scorer;
+
+    static void writeVarint(string &out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    static uint32_t readVarint(const string &in, size_t &pos) {
+        uint32_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            auto byte = static_cast<uint8_t>(in[pos++]);
+            value |= uint32_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+    }
+
+    // Послідовне декодування записів, починаючи з блоку
+    struct Cursor {
+        const ModelNameIndex &index;
+        size_t block;
+        size_t pos;
+        size_t inBlock = 0;
+        string name;
+        uint32_t sku = 0;
+
+        Cursor(const ModelNameIndex &index, size_t block)
+                : index(index), block(block), pos(block < index.blockOffsets.size() ? index.blockOffsets[block] : 0) {}
+
+        bool next() {
+            if (block >= index.blockOffsets.size()) return false;
+            if (inBlock == blockSize) {
+                if (++block >= index.blockOffsets.size()) return false;
+                pos = index.blockOffsets[block];
+                inBlock = 0;
+            }
+            if (pos >= index.data.size()) return false;
+            size_t shared = inBlock == 0 ? 0 : readVarint(index.data, pos);
+            size_t length = readVarint(index.data, pos);
+            name.resize(shared);
+            name.append(index.data, pos, length);
+            pos += length;
+            sku = readVarint(index.data, pos);
+            ++inBlock;
+            return true;
+        }
+    };
+
+    template<typename F>
+    void forEachInBlock(size_t block, F action) const {
+        Cursor cursor(*this, block);
+        while (cursor.next() && cursor.block == block) {
+            if (removed.empty() || !removed.count(cursor.name)) action(string_view(cursor.name), cursor.sku);
+        }
+    }
+
+    [[nodiscard]] string_view headOf(size_t block) const {
+        size_t pos = blockOffsets[block];
+        size_t length = readVarint(data, pos);
+        return {data.data() + pos, length};
+    }
+
+    // Перший блок, у якому можуть бути назви, не менші за key
+    [[nodiscard]] size_t firstBlockFor(string_view key) const {
+        size_t first = 0, last = blockOffsets.size();
+        while (first < last) {
+            size_t middle = (first + last) / 2;
+            if (headOf(middle) < key) first = middle + 1;
+            else last = middle;
+        }
+        return first == 0 ? 0 : first - 1;
+    }
+
+    // Найменший рядок, більший за всі рядки з префіксом (порожній, якщо такого немає)
+    static string prefixEnd(string_view prefix) {
+        string end(prefix);
+        while (!end.empty() && static_cast<unsigned char>(end.back()) == 0xFF) end.pop_back();
+        if (!end.empty()) end.back() = static_cast<char>(static_cast<unsigned char>(end.back()) + 1);
+        return end;
+    }
+
+    static bool hasPrefix(string_view name, string_view prefix) {
+        return name.substr(0, prefix.size()) == prefix;
+    }
+
+    double scoreOf(CompletionRank rank, uint32_t sku, string_view name) const {
+        return scorer ? scorer(rank, sku, name) : 0.0;
+    }
+
+    void refreshBlock(size_t block) {
+        for (size_t rank = 0; rank < rankCount; ++rank) {
+            float best = -numeric_limits<float>::infinity();
+            forEachInBlock(block, [&](string_view name, uint32_t sku) {
+                best = max(best, static_cast<float>(scoreOf(static_cast<CompletionRank>(rank), sku, name)));
+            });
+            auto &tree = trees[rank];
+            size_t node = treeSize + block;
+            tree[node] = best;
+            for (node /= 2; node > 0; node /= 2) {
+                tree[node] = max(tree[2 * node], tree[2 * node + 1]);
+            }
+        }
+    }
+
+    void encode(const vector<pair<string, uint32_t>> &entries) {
+        data.clear();
+        blockOffsets.clear();
+        blockOfSku.clear();
+        const string *previous = nullptr;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const auto &[name, sku] = entries[i];
+            if (i % blockSize == 0) {
+                blockOffsets.push_back(static_cast<uint32_t>(data.size()));
+                writeVarint(data, static_cast<uint32_t>(name.size()));
+                data += name;
+            } else {
+                size_t shared = 0;
+                while (shared < name.size() && shared < previous->size() && name[shared] == (*previous)[shared]) {
+                    ++shared;
+                }
+                writeVarint(data, static_cast<uint32_t>(shared));
+                writeVarint(data, static_cast<uint32_t>(name.size() - shared));
+                data.append(name, shared);
+            }
+            writeVarint(data, sku);
+            if (sku >= blockOfSku.size()) blockOfSku.resize(sku + 1, noBlock);
+            blockOfSku[sku] = static_cast<uint32_t>(i / blockSize);
+            previous = &name;
+        }
+        data.shrink_to_fit();
+        blockOffsets.shrink_to_fit();
+        encodedCount = entries.size();
+        rescore();
+    }
+
+    void rebuild() {
+        vector<pair<string, uint32_t>> entries;
+        entries.reserve(encodedCount + added.size());
+        Cursor cursor(*this, 0);
+        auto pending = added.begin();
+        while (cursor.next()) {
+            if (removed.count(cursor.name)) continue;
+            while (pending != added.end() && pending->first < cursor.name) entries.emplace_back(*pending++);
+            entries.emplace_back(cursor.name, cursor.sku);
+        }
+        entries.insert(entries.end(), pending, added.end());
+        added.clear();
+        removed.clear();
+        encode(entries);
+    }
+
+    void maybeRebuild() {
+        if (added.size() + removed.size() > max<size_t>(256, encodedCount / 64)) rebuild();
+    }
+
+public:
+    // Оцінка назви для кожного критерію; викликається лише для невеликої кількості назв
+    void setScorer(Scorer score) {
+        scorer = std::move(score);
+        rebuild();
+    }
+
+    void add(const string &name, uint32_t sku) {
+        added[name] = sku;
+        maybeRebuild();
+    }
+
+    void remove(const string &name, uint32_t sku) {
+        if (added.erase(name)) return;
+        removed.insert(name);
+        refresh(sku);
+        maybeRebuild();
+    }
+
+    // Оцінка SKU змінилась: перераховується максимум його блоку, O(розміру блоку + log n)
+    void refresh(uint32_t sku) {
+        if (sku < blockOfSku.size() && blockOfSku[sku] != noBlock) refreshBlock(blockOfSku[sku]);
+    }
+
+    void clear() {
+        added.clear();
+        removed.clear();
+        encode({});
+    }
+
+    // Повний перерахунок дерев оцінок (наприклад, після відновлення історії продажів)
+    void rescore() {
+        treeSize = 1;
+        while (treeSize < blockOffsets.size()) treeSize <<= 1;
+        for (size_t rank = 0; rank < rankCount; ++rank) {
+            auto &tree = trees[rank];
+            tree.assign(2 * treeSize, -numeric_limits<float>::infinity());
+            Cursor cursor(*this, 0);
+            while (cursor.next()) {
+                if (!removed.empty() && removed.count(cursor.name)) continue;
+                auto score = static_cast<float>(scoreOf(static_cast<CompletionRank>(rank), cursor.sku, cursor.name));
+                float &leaf = tree[treeSize + cursor.block];
+                leaf = max(leaf, score);
+            }
+            for (size_t node = treeSize - 1; node > 0; --node) {
+                tree[node] = max(tree[2 * node], tree[2 * node + 1]);
+            }
+        }
+    }
+
+    // Злиття накопичених змін (наприклад, після масового завантаження)
+    void compact() {
+        if (!added.empty() || !removed.empty()) rebuild();
+    }
+
+    // Обхід назв з префіксом у алфавітному порядку
+    template<typename F>
+    void forEachWithPrefix(string_view prefix, F action) const {
+        Cursor cursor(*this, firstBlockFor(prefix));
+        auto pending = added.lower_bound(string(prefix));
+        bool more = cursor.next();
+        while (more && cursor.name < prefix) more = cursor.next();
+        while (true) {
+            bool fromEncoded = more && hasPrefix(cursor.name, prefix);
+            bool fromPending = pending != added.end() && hasPrefix(pending->first, prefix);
+            if (!fromEncoded && !fromPending) break;
+            if (fromEncoded && (!fromPending || cursor.name < pending->first)) {
+                if (removed.empty() || !removed.count(cursor.name)) action(string_view(cursor.name), cursor.sku);
+                more = cursor.next();
+            } else {
+                action(string_view(pending->first), pending->second);
+                ++pending;
+            }
+        }
+    }
+
+    // k назв з префіксом з найбільшою оцінкою; за рівних оцінок - в алфавітному порядку
+    [[nodiscard]] vector<string> complete(string_view prefix, size_t k, CompletionRank rank) const {
+        if (k == 0) return {};
+        struct Candidate {
+            double score;
+            string name;
+            size_t block;
+        };
+        auto better = [](const Candidate &a, const Candidate &b) {
+            return a.score != b.score ? a.score > b.score : a.name < b.name;
+        };
+        // На вершині купи - найгірший з відібраних кандидатів
+        priority_queue<Candidate, vector<Candidate>, decltype(better)> best(better);
+        auto offer = [&](double score, string_view name, size_t block) {
+            Candidate candidate{score, string(name), block};
+            if (best.size() < k) {
+                best.push(std::move(candidate));
+            } else if (better(candidate, best.top())) {
+                best.pop();
+                best.push(std::move(candidate));
+            }
+        };
+
+        if (!blockOffsets.empty()) {
+            size_t firstBlock = firstBlockFor(prefix);
+            string end = prefixEnd(prefix);
+            size_t lastBlock = end.empty() ? blockOffsets.size() : firstBlockFor(end) + 1; // Не включно
+
+            // Пошук від вузлів з найбільшим максимумом; за рівності - від лівіших (алфавітно менших) блоків
+            struct Node {
+                float score;
+                size_t node, from, to;
+            };
+            auto lower = [](const Node &a, const Node &b) {
+                return a.score != b.score ? a.score < b.score : a.from > b.from;
+            };
+            priority_queue<Node, vector<Node>, decltype(lower)> frontier(lower);
+            const auto &tree = trees[static_cast<size_t>(rank)];
+            frontier.push({tree[1], 1, 0, treeSize});
+            while (!frontier.empty()) {
+                Node top = frontier.top();
+                frontier.pop();
+                if (top.to <= firstBlock || top.from >= lastBlock) continue;
+                if (top.score == -numeric_limits<float>::infinity()) break;
+                // Решта вузлів не може витіснити жодного з відібраних кандидатів: їхні оцінки менші,
+                // а за рівних оцінок назви в них алфавітно пізніші
+                if (best.size() == k) {
+                    auto worst = static_cast<float>(best.top().score);
+                    if (top.score < worst || (top.score == worst && top.from > best.top().block)) break;
+                }
+                if (top.to - top.from == 1) {
+                    forEachInBlock(top.from, [&](string_view name, uint32_t sku) {
+                        if (hasPrefix(name, prefix)) offer(scoreOf(rank, sku, name), name, top.from);
+                    });
+                    continue;
+                }
+                size_t middle = (top.from + top.to) / 2;
+                frontier.push({tree[2 * top.node], 2 * top.node, top.from, middle});
+                frontier.push({tree[2 * top.node + 1], 2 * top.node + 1, middle, top.to});
+            }
+        }
+
+        for (auto it = added.lower_bound(string(prefix)); it != added.end() && hasPrefix(it->first, prefix); ++it) {
+            offer(scoreOf(rank, it->second, it->first), it->first, SIZE_MAX);
+        }
+
+        vector<string> result(best.size());
+        for (size_t i = result.size(); i-- > 0; best.pop()) {
+            result[i] = best.top().name;
+        }
+        return result;
+    }
+
+    [[nodiscard]] size_t size() const { return encodedCount + added.size() - removed.size(); }
+
+    // Пам'ять закодованого словника разом з деревами оцінок (без буферів змін)
+    [[nodiscard]] size_t encodedBytes() const {
+        size_t bytes = data.capacity() + blockOffsets.capacity() * sizeof(uint32_t) +
+                       blockOfSku.capacity() * sizeof(uint32_t);
+        for (const auto &tree: trees) bytes += tree.capacity() * sizeof(float);
+        return bytes;
+    }
+
+    // Уся пам'ять словника разом з буферами змін
+    [[nodiscard]] size_t memoryBytes() const {
+        size_t bytes = encodedBytes() + treeBytes(added) + treeBytes(removed);
+        for (const auto &[name, sku]: added) bytes += heapBytes(name);
+        for (const auto &name: removed) bytes += heapBytes(name);
+        return bytes;
+    }
+};
+
+// Накопичувана статистика продажів однієї моделі
+struct ModelSales {
+    long long units = 0;
+    double revenue = 0;
+    long long orders = 0;
+};
+
+// Статистика продажів за моделями, що оновлюється з кожним замовленням
+// Рейтинги зберігаються впорядкованими, тому запит топ-N не залежить від розміру історії
+class SalesAnalytics {
+    unordered_map<string, ModelSales> byModel;
+    set<pair<long long, string>> byUnits;  // (-кількість, модель)
+    set<pair<double, string>> byRevenue;   // (-виручка, модель)
+
+    template<typename Key>
+    static vector<pair<string, ModelSales>> top(const set<pair<Key, string>> &ranking,
+                                                const unordered_map<string, ModelSales> &stats, size_t n) {
+        vector<pair<string, ModelSales>> result;
+        result.reserve(min(n, ranking.size()));
+        for (auto it = ranking.begin(); it != ranking.end() && result.size() < n; ++it) {
+            result.emplace_back(it->second, stats.at(it->second));
+        }
+        return result;
+    }
+
+public:
+    // Облік відправленого замовлення; знижка розподіляється між позиціями пропорційно їх вартості
+    void record(const Order &order) {
+        double gross = 0;
+        for (const auto &item: order.getItems()) {
+            gross += item.getTotalPrice();
+        }
+        double factor = gross > 0 ? order.calculateTotalPrice() / gross : 0;
+
+        // Одна модель може зустрічатись у кількох позиціях замовлення
+        vector<pair<const string *, ModelSales>> lines;
+        for (const auto &item: order.getItems()) {
+            const string &model = item.getBike()->getModel();
+            auto line = find_if(lines.begin(), lines.end(), [&](const auto &l) { return *l.first == model; });
+            if (line == lines.end()) {
+                lines.push_back({&model, {0, 0, 1}});
+                line = lines.end() - 1;
+            }
+            line->second.units += item.getQuantity();
+            line->second.revenue += item.getTotalPrice() * factor;
+        }
+
+        for (const auto &[model, delta]: lines) {
+            ModelSales &stats = byModel[*model];
+            byUnits.erase({-stats.units, *model});
+            byRevenue.erase({-stats.revenue, *model});
+            stats.units += delta.units;
+            stats.revenue += delta.revenue;
+            stats.orders += delta.orders;
+            byUnits.emplace(-stats.units, *model);
+            byRevenue.emplace(-stats.revenue, *model);
+        }
+    }
+
+    void clear() {
+        byModel.clear();
+        byUnits.clear();
+        byRevenue.clear();
+    }
+
+    // Статистика моделі або nullptr, якщо її ще не продавали
+    [[nodiscard]] const ModelSales *get(const string &model) const {
+        auto it = byModel.find(model);
+        return it == byModel.end() ? nullptr : &it->second;
+    }
+
+    [[nodiscard]] vector<pair<string, ModelSales>> topByUnits(size_t n) const {
+        return top(byUnits, byModel, n);
+    }
+
+    [[nodiscard]] vector<pair<string, ModelSales>> topByRevenue(size_t n) const {
+        return top(byRevenue, byModel, n);
+    }
+
+    [[nodiscard]] size_t modelCount() const { return byModel.size(); }
+
+    [[nodiscard]] size_t memoryBytes() const {
+        size_t bytes = tableBytes(byModel) + treeBytes(byUnits) + treeBytes(byRevenue);
+        for (const auto &[model, stats]: byModel) bytes += heapBytes(model);
+        for (const auto &entry: byUnits) bytes += heapBytes(entry.second);
+        for (const auto &entry: byRevenue) bytes += heapBytes(entry.second);
+        return bytes;
+    }
+};
+
+// Агреговані продажі за проміжок часу
+struct SalesBucket {
+    long long units = 0;
+    double revenue = 0;
+    long long orders = 0;
+
+    SalesBucket &operator+=(const SalesBucket &other) {
+        units += other.units;
+        revenue += other.revenue;
+        orders += other.orders;
+        return *this;
+    }
+};
+
+enum class TimeGranularity {
+    Minute = 60,
+    Hour = 3600,
+    Day = 86400
+};
+
+// Продажі за хвилинами, годинами і днями (UTC), загалом і для кожної моделі
+// Запит за вікном складається з грубих кошиків усередині і дрібних по краях: O(кошиків), а не O(замовлень)
+class SalesTimeline {
+    struct Rollup {
+        map<long long, SalesBucket> minutes, hours, days; // Початок кошика -> продажі
+
+        map<long long, SalesBucket> &level(TimeGranularity granularity) {
+            return granularity == TimeGranularity::Minute ? minutes : granularity == TimeGranularity::Hour ? hours
+                                                                                                           : days;
+        }
+
+        [[nodiscard]] const map<long long, SalesBucket> &level(TimeGranularity granularity) const {
+            return const_cast<Rollup *>(this)->level(granularity);
+        }
+
+        void add(long long timestamp, const SalesBucket &sale) {
+            minutes[floorTo(timestamp, TimeGranularity::Minute)] += sale;
+            hours[floorTo(timestamp, TimeGranularity::Hour)] += sale;
+            days[floorTo(timestamp, TimeGranularity::Day)] += sale;
+        }
+    };
+
+    Rollup total;
+    unordered_map<string, Rollup> byModel;
+
+    static long long floorTo(long long timestamp, TimeGranularity granularity) {
+        auto step = static_cast<long long>(granularity);
+        return timestamp - ((timestamp % step) + step) % step;
+    }
+
+    static long long ceilTo(long long timestamp, TimeGranularity granularity) {
+        long long floor = floorTo(timestamp, granularity);
+        return floor == timestamp ? floor : floor + static_cast<long long>(granularity);
+    }
+
+    static void sumRange(const map<long long, SalesBucket> &buckets, long long from, long long to,
+                         SalesBucket &result) {
+        for (auto it = buckets.lower_bound(from); it != buckets.end() && it->first < to; ++it) {
+            result += it->second;
+        }
+    }
+
+    static SalesBucket query(const Rollup &rollup, long long from, long long to) {
+        SalesBucket result;
+        from = floorTo(from, TimeGranularity::Minute);
+        to = ceilTo(to, TimeGranularity::Minute);
+        if (from >= to) return result;
+
+        long long hourFrom = ceilTo(from, TimeGranularity::Hour);
+        long long hourTo = floorTo(to, TimeGranularity::Hour);
+        if (hourFrom >= hourTo) {
+            sumRange(rollup.minutes, from, to, result);
+            return result;
+        }
+        sumRange(rollup.minutes, from, hourFrom, result);
+        sumRange(rollup.minutes, hourTo, to, result);
+
+        long long dayFrom = ceilTo(hourFrom, TimeGranularity::Day);
+        long long dayTo = floorTo(hourTo, TimeGranularity::Day);
+        if (dayFrom >= dayTo) {
+            sumRange(rollup.hours, hourFrom, hourTo, result);
+            return result;
+        }
+        sumRange(rollup.hours, hourFrom, dayFrom, result);
+        sumRange(rollup.hours, dayTo, hourTo, result);
+        sumRange(rollup.days, dayFrom, dayTo, result);
+        return result;
+    }
+
+public:
+    void record(const Order &order) {
+        long long timestamp = order.getSoldAt();
+        if (timestamp == 0) return; // Час продажу невідомий (дані старого формату)
+
+        double gross = 0;
+        for (const auto &item: order.getItems()) {
+            gross += item.getTotalPrice();
+        }
+        double factor = gross > 0 ? order.calculateTotalPrice() / gross : 0;
+
+        total.add(timestamp, {order.getTotalItems(), order.calculateTotalPrice(), 1});
+        for (size_t i = 0; i < order.getItems().size(); ++i) {
+            const OrderItem &item = order.getItems()[i];
+            const string &model = item.getBike()->getModel();
+            // Замовлення враховується для моделі лише один раз
+            bool repeated = any_of(order.getItems().begin(), order.getItems().begin() + static_cast<ptrdiff_t>(i),
+                                   [&](const OrderItem &other) { return other.getBike()->getModel() == model; });
+            byModel[model].add(timestamp, {item.getQuantity(), item.getTotalPrice() * factor, repeated ? 0 : 1});
+        }
+    }
+
+    void clear() {
+        total = Rollup();
+        byModel.clear();
+    }
+
+    // Продажі за вікно [from, to); межі округлюються до хвилин
+    [[nodiscard]] SalesBucket totalBetween(long long from, long long to) const {
+        return query(total, from, to);
+    }
+
+    [[nodiscard]] SalesBucket modelBetween(const string &model, long long from, long long to) const {
+        auto it = byModel.find(model);
+        return it == byModel.end() ? SalesBucket() : query(it->second, from, to);
+    }
+
+    // Ряд непорожніх кошиків заданої гранулярності, що починаються у [from, to)
+    [[nodiscard]] vector<pair<long long, SalesBucket>> series(TimeGranularity granularity, long long from,
+                                                              long long to, const string &model = "") const {
+        vector<pair<long long, SalesBucket>> result;
+        const Rollup *rollup = &total;
+        if (!model.empty()) {
+            auto it = byModel.find(model);
+            if (it == byModel.end()) return result;
+            rollup = &it->second;
+        }
+        const auto &buckets = rollup->level(granularity);
+        for (auto it = buckets.lower_bound(floorTo(from, granularity)); it != buckets.end() && it->first < to; ++it) {
+            result.emplace_back(it->first, it->second);
+        }
+        return result;
+    }
+
+    [[nodiscard]] size_t memoryBytes() const {
+        auto rollupBytes = [](const Rollup &rollup) {
+            return treeBytes(rollup.minutes) + treeBytes(rollup.hours) + treeBytes(rollup.days);
+        };
+        size_t bytes = rollupBytes(total) + tableBytes(byModel);
+        for (const auto &[model, rollup]: byModel) bytes += heapBytes(model) + rollupBytes(rollup);
+        return bytes;
+    }
+};
+
+// Замовлення і накопичена вартість одного покупця
+struct CustomerStats {
+    vector<size_t> orders;   // Порядкові номери замовлень в історії магазину
+    double lifetimeValue = 0;
+    long long orderCount = 0;
+
+    void add(size_t ordinal, double value) {
+        orders.push_back(ordinal);
+        lifetimeValue += value;
+        ++orderCount;
+    }
+
+    // Приєднання статистики пізніших замовлень того самого покупця
+    void append(const CustomerStats &later) {
+        orders.insert(orders.end(), later.orders.begin(), later.orders.end());
+        lifetimeValue += later.lifetimeValue;
+        orderCount += later.orderCount;
+    }
+};
+
+// Операції магазину, для яких ведуться гістограми затримок
+enum class ShopOperation {
+    AddBike,
+    RestockBike,
+    FindBikeByModel,
+    EditBike,
+    RemoveBike,
+    DisplayInventory,
+    CheckInventoryForOrder,
+    ShipOrder,
+    DisplayOrders,
+    PageInventory,
+    PageOrders,
+    ExportInventory,
+    ExportOrders,
+    SaveAllDataToFile,
+    LoadFromFile,
+    HoldStock,
+    ReleaseStock,
+    GetAvailableQuantity,
+    FilterCatalog,
+    Autocomplete,
+    SetReorderPoint,
+    RebuildCustomerIndex,
+    GetCustomerOrders,
+    Count
+};
+
+inline constexpr array<const char *, static_cast<size_t>(ShopOperation::Count)> shopOperationNames = {
+        "addBike", "restockBike", "findBikeByModel", "editBike", "removeBike", "displayInventory",
+        "checkInventoryForOrder", "shipOrder", "displayOrders", "pageInventory", "pageOrders", "exportInventory",
+        "exportOrders", "saveAllDataToFile", "loadFromfile", "holdStock", "releaseStock", "getAvailableQuantity",
+        "filterCatalog", "autocomplete", "setReorderPoint", "rebuildCustomerIndex", "getCustomerOrders"};
+
+// Дешевий годинник для вимірювання затримок: лічильник тактів процесора на x86, інакше steady_clock
+// Такти переводяться в наносекунди лише під час звіту, за співвідношенням з steady_clock від старту програми
+class MetricsClock {
+    struct Origin {
+        uint64_t ticks;
+        chrono::steady_clock::time_point time;
+    };
+
+    static Origin &origin() {
+        static Origin start{now(), chrono::steady_clock::now()};
+        return start;
+    }
+
+public:
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Викликається якомога раніше, щоб калібрування охоплювало довший проміжок
+    static void start() {
+        (void) origin();
+    }
+
+    // Показ лічильника в момент старту, від якого відлічуються часові мітки трас
+    static uint64_t originTicks() {
+        return origin().ticks;
+    }
+
+    static double nanosecondsPerTick() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        const Origin &start = origin();
+        // Занадто короткий проміжок дає неточне співвідношення
+        while (chrono::steady_clock::now() - start.time < chrono::milliseconds(20)) {}
+        uint64_t ticks = now() - start.ticks;
+        double nanoseconds = chrono::duration<double, nano>(chrono::steady_clock::now() - start.time).count();
+        return ticks ? nanoseconds / static_cast<double>(ticks) : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+};
+
+// Знімок гістограми: лічильники логарифмічно-лінійних кошиків (по 32 на кожен степінь двійки,
+// відносна похибка до ~3%) у тактах MetricsClock
+struct LatencySnapshot {
+    static constexpr unsigned subBucketBits = 5;
+    static constexpr unsigned maxShift = 40;
+    static constexpr size_t bucketCount = (maxShift + 2) << subBucketBits;
+
+    vector<uint64_t> buckets = vector<uint64_t>(bucketCount);
+    uint64_t count = 0; // Виміри в кошиках
+    uint64_t total = 0;
+    uint64_t max = 0;
+    uint64_t calls = 0; // Усі зараховані виклики, разом з невиміряними (для гістограм операцій магазину)
+
+    static size_t bucketOf(uint64_t value) {
+        unsigned shift = 0;
+        if (value >> (subBucketBits + 1)) {
+            shift = min<unsigned>(bit_width(value) - 1 - subBucketBits, maxShift);
+        }
+        uint64_t sub = min<uint64_t>(value >> shift, (uint64_t(2) << subBucketBits) - 1);
+        return (size_t(shift) << subBucketBits) + sub;
+    }
+
+    // Середина діапазону значень кошика
+    static double valueOf(size_t bucket) {
+        size_t shift = bucket < (size_t(2) << subBucketBits) ? 0 : (bucket >> subBucketBits) - 1;
+        uint64_t sub = bucket - (shift << subBucketBits);
+        return ldexp(static_cast<double>(sub) + (shift ? 0.5 : 0.0), static_cast<int>(shift));
+    }
+
+    // Запис одного виміру у знімок, що належить одному потоку
+    void add(uint64_t ticks) {
+        ++buckets[bucketOf(ticks)];
+        ++count;
+        total += ticks;
+        max = std::max(max, ticks);
+    }
+
+    void merge(const LatencySnapshot &other) {
+        for (size_t i = 0; i < bucketCount; ++i) buckets[i] += other.buckets[i];
+        count += other.count;
+        total += other.total;
+        max = std::max(max, other.max);
+        calls += other.calls;
+    }
+
+    // Значення квантиля q (0..1) у тактах
+    [[nodiscard]] double quantile(double q) const {
+        if (count == 0) return 0;
+        auto rank = static_cast<uint64_t>(ceil(q * static_cast<double>(count)));
+        rank = clamp<uint64_t>(rank, 1, count);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucketCount; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return std::min(valueOf(i), static_cast<double>(max));
+        }
+        return static_cast<double>(max);
+    }
+};
+
+// Гістограма одного потоку: пише лише власний потік, тож атомарні операції без блокування шини;
+// інші потоки можуть читати її під час злиття
+class LatencyHistogram {
+    array<atomic<uint64_t>, LatencySnapshot::bucketCount> buckets{};
+    atomic<uint64_t> count{0};
+    atomic<uint64_t> total{0};
+    atomic<uint64_t> max{0};
+    atomic<uint64_t> calls{0};
+    uint32_t countdown = 1; // Викликів до наступного виміру; лише потік-власник
+
+    static void bump(atomic<uint64_t> &counter, uint64_t delta) {
+        counter.store(counter.load(memory_order_relaxed) + delta, memory_order_relaxed);
+    }
+
+public:
+    // Зарахування виклику; true, якщо його тривалість треба виміряти (кожен interval-й виклик)
+    bool sample(uint32_t interval) {
+        bump(calls, 1);
+        if (--countdown != 0) return false;
+        countdown = interval;
+        return true;
+    }
+
+    void record(uint64_t ticks) {
+        bump(buckets[LatencySnapshot::bucketOf(ticks)], 1);
+        bump(count, 1);
+        bump(total, ticks);
+        if (ticks > max.load(memory_order_relaxed)) max.store(ticks, memory_order_relaxed);
+    }
+
+    void addTo(LatencySnapshot &snapshot) const {
+        for (size_t i = 0; i < buckets.size(); ++i) snapshot.buckets[i] += buckets[i].load(memory_order_relaxed);
+        snapshot.count += count.load(memory_order_relaxed);
+        snapshot.total += total.load(memory_order_relaxed);
+        snapshot.max = std::max(snapshot.max, max.load(memory_order_relaxed));
+        snapshot.calls += calls.load(memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto &bucket: buckets) bucket.store(0, memory_order_relaxed);
+        calls.store(0, memory_order_relaxed);
+        count.store(0, memory_order_relaxed);
+        total.store(0, memory_order_relaxed);
+        max.store(0, memory_order_relaxed);
+    }
+};
+
+// Гістограми затримок операцій магазину з усіх потоків
+// Кожен потік пише у власні гістограми; знімок зливає їх на вимогу. Гістограми завершених потоків
+// переносяться у спільний підсумок, тож їхні виміри не губляться
+// За замовчуванням вимірюється кожен виклик, тож p999 і max бачать усі викиди. Читання лічильника тактів
+// коштує ~7-14 нс; де вимір кожного виклику не вкладається в бюджет, setSampleInterval(N) явно вмикає вибірку:
+// тоді зараховуються всі виклики, а тривалість (і квантилі з max) - лише кожного N-го виклику в потоці
+class LatencyMetrics {
+    static constexpr size_t operationCount = static_cast<size_t>(ShopOperation::Count);
+    using Histograms = array<LatencyHistogram, operationCount>;
+
+    struct Registry {
+        mutex lock;
+        vector<Histograms *> live;
+        array<LatencySnapshot, operationCount> retired;
+    };
+
+    static Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    struct ThreadHistograms {
+        Histograms histograms;
+
+        ThreadHistograms() {
+            MetricsClock::start();
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            shared.live.push_back(&histograms);
+        }
+
+        ~ThreadHistograms() {
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            for (size_t i = 0; i < operationCount; ++i) histograms[i].addTo(shared.retired[i]);
+            erase(shared.live, &histograms);
+        }
+    };
+
+    static Histograms &registerThread() {
+        thread_local ThreadHistograms histograms;
+        return histograms.histograms;
+    }
+
+    // Тривіальний thread_local-вказівник не потребує перевірки ініціалізації при кожному доступі
+    static Histograms &local() {
+        static thread_local Histograms *histograms = nullptr;
+        if (!histograms) [[unlikely]] histograms = &registerThread();
+        return *histograms;
+    }
+
+    static inline atomic<uint32_t> sampleInterval{1};
+
+public:
+    // Гістограма операції поточного потоку
+    static LatencyHistogram &histogram(ShopOperation operation) {
+        return local()[static_cast<size_t>(operation)];
+    }
+
+    static void record(ShopOperation operation, uint64_t ticks) {
+        histogram(operation).record(ticks);
+    }
+
+    // 1 (за замовчуванням) - вимірюється кожен виклик; нове значення діє після поточного інтервалу кожного потоку
+    static void setSampleInterval(uint32_t interval) {
+        if (interval == 0) throw invalid_argument("Sample interval must be positive.");
+        sampleInterval.store(interval, memory_order_relaxed);
+    }
+
+    [[nodiscard]] static uint32_t getSampleInterval() {
+        return sampleInterval.load(memory_order_relaxed);
+    }
+
+    [[nodiscard]] static array<LatencySnapshot, operationCount> snapshot() {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        auto result = shared.retired;
+        for (const Histograms *histograms: shared.live) {
+            for (size_t i = 0; i < operationCount; ++i) (*histograms)[i].addTo(result[i]);
+        }
+        return result;
+    }
+
+    static void reset() {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        for (auto &retired: shared.retired) retired = LatencySnapshot{};
+        for (Histograms *histograms: shared.live) {
+            for (auto &histogram: *histograms) histogram.reset();
+        }
+    }
+
+    // Таблиця p50/p99/p999/max (нс) для операцій, які виконувались хоча б раз
+    static void writeText(ReportWriter &out) {
+        auto histograms = snapshot();
+        double scale = MetricsClock::nanosecondsPerTick();
+        uint32_t interval = getSampleInterval();
+        if (interval > 1) out << "# durations sampled every " << interval << "th call per thread\n";
+        out << "operation count sampled mean_ns p50_ns p99_ns p999_ns max_ns\n";
+        for (size_t i = 0; i < operationCount; ++i) {
+            const auto &h = histograms[i];
+            if (h.count == 0) continue;
+            out << shopOperationNames[i] << ' ' << h.calls << ' ' << h.count << ' '
+                << static_cast<double>(h.total) / static_cast<double>(h.count) * scale << ' '
+                << h.quantile(0.5) * scale << ' ' << h.quantile(0.99) * scale << ' '
+                << h.quantile(0.999) * scale << ' ' << static_cast<double>(h.max) * scale << '\n';
+        }
+        out.flush();
+    }
+
+    // Один JSON-об'єкт без завершального перенесення рядка, щоб його можна було вкласти в інший
+    static void writeJson(ReportWriter &out) {
+        auto histograms = snapshot();
+        double scale = MetricsClock::nanosecondsPerTick();
+        out << '{';
+        bool first = true;
+        for (size_t i = 0; i < operationCount; ++i) {
+            const auto &h = histograms[i];
+            if (h.count == 0) continue;
+            out << (first ? "" : ",") << '"' << shopOperationNames[i] << "\":{\"count\":" << h.calls
+                << ",\"sampled\":" << h.count << ",\"mean_ns\":" << static_cast<double>(h.total) / static_cast<double>(h.count) * scale
+                << ",\"p50_ns\":" << h.quantile(0.5) * scale << ",\"p99_ns\":" << h.quantile(0.99) * scale
+                << ",\"p999_ns\":" << h.quantile(0.999) * scale
+                << ",\"max_ns\":" << static_cast<double>(h.max) * scale << '}';
+            first = false;
+        }
+        out << '}';
+        out.flush();
+    }
+};
+
+// Вимір тривалості операції від створення до виходу з області видимості
+// Невиміряний виклик коштує лише лічильника викликів; start = 0 позначає такий виклик
+class ScopedLatency {
+    LatencyHistogram &histogram;
+    uint64_t start;
+
+public:
+    explicit ScopedLatency(ShopOperation operation)
+            : histogram(LatencyMetrics::histogram(operation)),
+              start(histogram.sample(LatencyMetrics::getSampleInterval()) ? MetricsClock::now() : 0) {}
+
+    ScopedLatency(const ScopedLatency &) = delete;
+    ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+    ~ScopedLatency() {
+        if (start) histogram.record(MetricsClock::now() - start);
+    }
+};
+
+// Кількість і сумарний розмір виділень пам'яті
+struct AllocationCounters {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+
+    AllocationCounters operator-(const AllocationCounters &other) const {
+        return {allocations - other.allocations, bytes - other.bytes};
+    }
+};
+
+// Підсумок виділень пам'яті однієї операції магазину за всі виклики
+struct AllocationStats {
+    uint64_t calls = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t maxAllocations = 0; // Найбільше за один виклик
+    uint64_t maxBytes = 0;
+};
+
+// Облік виділень пам'яті за операціями магазину, вмикається явно через enable()
+// Лічильники наповнює замінений operator new: його визначає одна одиниця трансляції, що оголошує
+// SHOP_ALLOCATION_HOOKS перед підключенням shop.h. Операції зараховуються всі виділення її потоку
+// від входу до виходу, разом із вкладеними операціями (shipOrder містить checkInventoryForOrder)
+class AllocationTracker {
+    static constexpr size_t operationCount = static_cast<size_t>(ShopOperation::Count);
+
+    // Лічильники однієї операції в одному потоці: пише лише власний потік
+    struct OperationCounters {
+        atomic<uint64_t> calls{0};
+        atomic<uint64_t> allocations{0};
+        atomic<uint64_t> bytes{0};
+        atomic<uint64_t> maxAllocations{0};
+        atomic<uint64_t> maxBytes{0};
+
+        void addTo(AllocationStats &stats) const {
+            stats.calls += calls.load(memory_order_relaxed);
+            stats.allocations += allocations.load(memory_order_relaxed);
+            stats.bytes += bytes.load(memory_order_relaxed);
+            stats.maxAllocations = max(stats.maxAllocations, maxAllocations.load(memory_order_relaxed));
+            stats.maxBytes = max(stats.maxBytes, maxBytes.load(memory_order_relaxed));
+        }
+
+        void reset() {
+            for (auto *counter: {&calls, &allocations, &bytes, &maxAllocations, &maxBytes}) {
+                counter->store(0, memory_order_relaxed);
+            }
+        }
+    };
+
+    using Counters = array<OperationCounters, operationCount>;
+
+    struct Registry {
+        mutex lock;
+        vector<Counters *> live;
+        array<AllocationStats, operationCount> retired;
+    };
+
+    static Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    struct ThreadCounters {
+        Counters counters;
+
+        ThreadCounters() {
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            shared.live.push_back(&counters);
+        }
+
+        ~ThreadCounters() {
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            for (size_t i = 0; i < operationCount; ++i) counters[i].addTo(shared.retired[i]);
+            erase(shared.live, &counters);
+        }
+    };
+
+    static Counters &registerThread() {
+        thread_local ThreadCounters counters;
+        return counters.counters;
+    }
+
+    static Counters &local() {
+        static thread_local Counters *counters = nullptr;
+        if (!counters) [[unlikely]] counters = &registerThread();
+        return *counters;
+    }
+
+    static void bump(atomic<uint64_t> &counter, uint64_t delta) {
+        counter.store(counter.load(memory_order_relaxed) + delta, memory_order_relaxed);
+    }
+
+    static void raise(atomic<uint64_t> &counter, uint64_t value) {
+        if (value > counter.load(memory_order_relaxed)) counter.store(value, memory_order_relaxed);
+    }
+
+    static inline atomic<bool> enabled{false};
+    static inline thread_local AllocationCounters threadCounters;
+    static inline atomic<uint64_t> processAllocations{0};
+    static inline atomic<uint64_t> processBytes{0};
+
+public:
+    static inline bool hooksInstalled = false;
+
+    // Викликається з operator new; не виділяє пам'ять і не блокує
+    static void onAllocate(size_t size) noexcept {
+        ++threadCounters.allocations;
+        threadCounters.bytes += size;
+        processAllocations.fetch_add(1, memory_order_relaxed);
+        processBytes.fetch_add(size, memory_order_relaxed);
+    }
+
+    static void enable(bool on = true) {
+        if (on && !hooksInstalled) {
+            throw logic_error("Allocation hooks are not installed: define SHOP_ALLOCATION_HOOKS in one source file.");
+        }
+        enabled.store(on, memory_order_relaxed);
+    }
+
+    [[nodiscard]] static bool isEnabled() {
+        return enabled.load(memory_order_relaxed);
+    }
+
+    // Усі виділення поточного потоку від його старту
+    [[nodiscard]] static AllocationCounters threadTotals() {
+        return threadCounters;
+    }
+
+    // Усі виділення процесу від старту
+    [[nodiscard]] static AllocationCounters processTotals() {
+        return {processAllocations.load(memory_order_relaxed), processBytes.load(memory_order_relaxed)};
+    }
+
+    static void record(ShopOperation operation, AllocationCounters delta) {
+        auto &counters = local()[static_cast<size_t>(operation)];
+        bump(counters.calls, 1);
+        bump(counters.allocations, delta.allocations);
+        bump(counters.bytes, delta.bytes);
+        raise(counters.maxAllocations, delta.allocations);
+        raise(counters.maxBytes, delta.bytes);
+    }
+
+    [[nodiscard]] static array<AllocationStats, operationCount> snapshot() {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        auto result = shared.retired;
+        for (const Counters *counters: shared.live) {
+            for (size_t i = 0; i < operationCount; ++i) (*counters)[i].addTo(result[i]);
+        }
+        return result;
+    }
+
+    static void reset() {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        for (auto &retired: shared.retired) retired = AllocationStats{};
+        for (Counters *counters: shared.live) {
+            for (auto &operation: *counters) operation.reset();
+        }
+    }
+
+    // Виділення, зроблені action у поточному потоці
+    template<typename F>
+    [[nodiscard]] static AllocationCounters measure(F &&action) {
+        if (!hooksInstalled) {
+            throw logic_error("Allocation hooks are not installed: define SHOP_ALLOCATION_HOOKS in one source file.");
+        }
+        auto before = threadTotals();
+        action();
+        return threadTotals() - before;
+    }
+
+    // Перевірка для тестів: action має вкластися у задану кількість виділень і байтів
+    template<typename F>
+    static void require(F &&action, uint64_t maxAllocations,
+                        uint64_t maxBytes = numeric_limits<uint64_t>::max()) {
+        auto used = measure(std::forward<F>(action));
+        if (used.allocations > maxAllocations || used.bytes > maxBytes) {
+            throw runtime_error("Allocation budget exceeded: " + to_string(used.allocations) + " allocations, " +
+                                to_string(used.bytes) + " bytes (limit " + to_string(maxAllocations) +
+                                " allocations, " + to_string(maxBytes) + " bytes).");
+        }
+    }
+
+    // Таблиця виділень на виклик для операцій, які виконувались під час обліку
+    static void writeText(ReportWriter &out) {
+        auto stats = snapshot();
+        out << "operation calls allocs_per_call bytes_per_call max_allocs max_bytes\n";
+        for (size_t i = 0; i < operationCount; ++i) {
+            const auto &s = stats[i];
+            if (s.calls == 0) continue;
+            auto calls = static_cast<double>(s.calls);
+            out << shopOperationNames[i] << ' ' << s.calls << ' ' << static_cast<double>(s.allocations) / calls << ' '
+                << static_cast<double>(s.bytes) / calls << ' ' << s.maxAllocations << ' ' << s.maxBytes << '\n';
+        }
+        out.flush();
+    }
+
+    // Один JSON-об'єкт без завершального перенесення рядка
+    static void writeJson(ReportWriter &out) {
+        auto stats = snapshot();
+        out << '{';
+        bool first = true;
+        for (size_t i = 0; i < operationCount; ++i) {
+            const auto &s = stats[i];
+            if (s.calls == 0) continue;
+            auto calls = static_cast<double>(s.calls);
+            out << (first ? "" : ",") << '"' << shopOperationNames[i] << "\":{\"calls\":" << s.calls
+                << ",\"allocs_per_call\":" << static_cast<double>(s.allocations) / calls
+                << ",\"bytes_per_call\":" << static_cast<double>(s.bytes) / calls
+                << ",\"max_allocs\":" << s.maxAllocations << ",\"max_bytes\":" << s.maxBytes << '}';
+            first = false;
+        }
+        out << '}';
+        out.flush();
+    }
+};
+
+// Облік виділень пам'яті операції від створення до виходу з області видимості
+class ScopedAllocations {
+    ShopOperation operation;
+    AllocationCounters start;
+    bool active;
+
+public:
+    explicit ScopedAllocations(ShopOperation operation)
+            : operation(operation), active(AllocationTracker::isEnabled()) {
+        if (active) start = AllocationTracker::threadTotals();
+    }
+
+    ScopedAllocations(const ScopedAllocations &) = delete;
+    ScopedAllocations &operator=(const ScopedAllocations &) = delete;
+
+    ~ScopedAllocations() {
+        if (active) AllocationTracker::record(operation, AllocationTracker::threadTotals() - start);
+    }
+};
+
+// Заміна глобальних operator new/delete для обліку виділень; лише в одній одиниці трансляції
+// GCC попереджає про free для пам'яті з operator new, хоча тут обидва оператори замінені узгоджено
+#ifdef SHOP_ALLOCATION_HOOKS
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size) {
+    AllocationTracker::onAllocate(size);
+    if (void *memory = malloc(size ? size : 1)) return memory;
+    throw bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    free(memory);
+}
+
+static const bool shopAllocationHooks = (AllocationTracker::hooksInstalled = true);
+#endif
+
+// Кільцевий буфер подій траси одного потоку
+// Пише лише власний потік без блокувань; читач копіює події під час запису і відкидає ті,
+// які могли бути перезаписані за час копіювання
+class TraceBuffer {
+public:
+    static constexpr size_t capacity = size_t(1) << 14;
+
+    struct Event {
+        const char *name;
+        uint64_t start;
+        uint64_t duration;
+    };
+
+private:
+    struct Slot {
+        atomic<const char *> name{nullptr};
+        atomic<uint64_t> start{0};
+        atomic<uint64_t> duration{0};
+    };
+
+    unique_ptr<Slot[]> slots{new Slot[capacity]};
+    atomic<uint64_t> head{0};
+    uint32_t thread;
+
+public:
+    explicit TraceBuffer(uint32_t thread) : thread(thread) {}
+
+    [[nodiscard]] uint32_t getThread() const { return thread; }
+
+    [[nodiscard]] bool empty() const { return head.load(memory_order_acquire) == 0; }
+
+    void push(const char *name, uint64_t start, uint64_t duration) {
+        uint64_t position = head.load(memory_order_relaxed);
+        Slot &slot = slots[position & (capacity - 1)];
+        slot.name.store(name, memory_order_relaxed);
+        slot.start.store(start, memory_order_relaxed);
+        slot.duration.store(duration, memory_order_relaxed);
+        head.store(position + 1, memory_order_release);
+    }
+
+    // Останні події (не більше capacity) у порядку запису
+    void collect(vector<Event> &events) const {
+        uint64_t end = head.load(memory_order_acquire);
+        uint64_t from = end > capacity ? end - capacity : 0;
+        size_t first = events.size();
+        for (uint64_t i = from; i < end; ++i) {
+            const Slot &slot = slots[i & (capacity - 1)];
+            events.push_back({slot.name.load(memory_order_relaxed), slot.start.load(memory_order_relaxed),
+                              slot.duration.load(memory_order_relaxed)});
+        }
+        atomic_thread_fence(memory_order_acquire);
+        // Слоти, до яких письменник міг дійти під час копіювання, ненадійні
+        uint64_t overwritten = head.load(memory_order_relaxed);
+        if (overwritten > from + capacity) {
+            auto stale = static_cast<ptrdiff_t>(min<uint64_t>(overwritten - capacity - from, end - from));
+            events.erase(events.begin() + static_cast<ptrdiff_t>(first), events.begin() + static_cast<ptrdiff_t>(first) + stale);
+        }
+    }
+
+    void clear() {
+        head.store(0, memory_order_release);
+    }
+};
+
+// Траса фаз операцій магазину у форматі Chrome trace (chrome://tracing, Perfetto)
+// Вмикається під час роботи через enable(); вимкнений запис коштує одного читання прапорця
+// Кожен потік пише у власний кільцевий буфер з останніми TraceBuffer::capacity подіями
+class Tracer {
+    // Буфери завершених потоків зберігаються, доки їх не більше за цю кількість
+    static constexpr size_t maxRetiredBuffers = 64;
+
+    struct Registry {
+        mutex lock;
+        vector<shared_ptr<TraceBuffer>> live;
+        deque<shared_ptr<TraceBuffer>> retired;
+        uint32_t nextThread = 1;
+    };
+
+    static Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    struct ThreadBuffer {
+        shared_ptr<TraceBuffer> buffer;
+
+        ThreadBuffer() {
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            buffer = make_shared<TraceBuffer>(shared.nextThread++);
+            shared.live.push_back(buffer);
+        }
+
+        ~ThreadBuffer() {
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            erase(shared.live, buffer);
+            if (buffer->empty()) return;
+            shared.retired.push_back(std::move(buffer));
+            if (shared.retired.size() > maxRetiredBuffers) shared.retired.pop_front();
+        }
+    };
+
+    static TraceBuffer &registerThread() {
+        thread_local ThreadBuffer buffer;
+        return *buffer.buffer;
+    }
+
+    static TraceBuffer &local() {
+        static thread_local TraceBuffer *buffer = nullptr;
+        if (!buffer) [[unlikely]] buffer = &registerThread();
+        return *buffer;
+    }
+
+    static inline atomic<bool> enabled{false};
+
+public:
+    static void enable(bool on = true) {
+        if (on) MetricsClock::start();
+        enabled.store(on, memory_order_relaxed);
+    }
+
+    [[nodiscard]] static bool isEnabled() {
+        return enabled.load(memory_order_relaxed);
+    }
+
+    // name має жити до запису траси (зазвичай рядковий літерал)
+    static void record(const char *name, uint64_t start, uint64_t finish) {
+        local().push(name, start, finish - start);
+    }
+
+    static void clear() {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        shared.retired.clear();
+        for (auto &buffer: shared.live) buffer->clear();
+    }
+
+    // Об'єкт Chrome trace з усіма подіями, упорядкованими за часом початку; часи в мікросекундах
+    static void writeChromeJson(ReportWriter &out) {
+        struct ThreadEvent {
+            TraceBuffer::Event event;
+            uint32_t thread;
+        };
+        vector<ThreadEvent> events;
+        {
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            vector<TraceBuffer::Event> buffered;
+            auto gather = [&](const TraceBuffer &buffer) {
+                buffered.clear();
+                buffer.collect(buffered);
+                for (const auto &event: buffered) events.push_back({event, buffer.getThread()});
+            };
+            for (const auto &buffer: shared.retired) gather(*buffer);
+            for (const auto &buffer: shared.live) gather(*buffer);
+        }
+        sort(events.begin(), events.end(), [](const ThreadEvent &a, const ThreadEvent &b) {
+            return a.event.start < b.event.start;
+        });
+        double microsecondsPerTick = MetricsClock::nanosecondsPerTick() / 1000;
+        uint64_t origin = MetricsClock::originTicks();
+        out << "{\"traceEvents\":[";
+        for (size_t i = 0; i < events.size(); ++i) {
+            const auto &[event, thread] = events[i];
+            uint64_t start = event.start > origin ? event.start - origin : 0;
+            out << (i ? ",\n" : "\n") << "{\"name\":";
+            out.json(event.name ? event.name : "?");
+            out << ",\"cat\":\"shop\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+                << ",\"ts\":";
+            out.exact(static_cast<double>(start) * microsecondsPerTick);
+            out << ",\"dur\":";
+            out.exact(static_cast<double>(event.duration) * microsecondsPerTick);
+            out << '}';
+        }
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        out.flush();
+    }
+
+    static void writeChromeJsonToFile(const string &file) {
+        FILE *output = fopen(file.c_str(), "wb");
+        if (!output) throw runtime_error("Failed to open file for writing.");
+        try {
+            FileSink sink(output);
+            ReportWriter out(sink);
+            writeChromeJson(out);
+        } catch (...) {
+            fclose(output);
+            throw;
+        }
+        if (fclose(output) != 0) throw runtime_error("Failed to write trace file.");
+    }
+};
+
+// Відрізок траси від створення до виходу з області видимості
+class TraceSpan {
+    const char *name;
+    uint64_t start;
+
+public:
+    explicit TraceSpan(const char *name) : name(Tracer::isEnabled() ? name : nullptr),
+                                           start(this->name ? MetricsClock::now() : 0) {}
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    ~TraceSpan() {
+        if (name) Tracer::record(name, start, MetricsClock::now());
+    }
+};
+
+// Збирання з SHOP_NO_METRICS повністю прибирає виміри з операцій магазину; SHOP_NO_ALLOCATION_METRICS
+// і SHOP_NO_TRACE прибирають лише облік виділень пам'яті чи трасу, залишаючи гістограми затримок
+// SHOP_TRACE позначає фазу всередині операції; самі операції потрапляють у трасу через SHOP_MEASURE
+#define SHOP_CONCAT_(a, b) a##b
+#define SHOP_CONCAT(a, b) SHOP_CONCAT_(a, b)
+#if defined(SHOP_NO_METRICS) || defined(SHOP_NO_ALLOCATION_METRICS)
+#define SHOP_MEASURE_ALLOCATIONS(operation) ((void) 0)
+#else
+#define SHOP_MEASURE_ALLOCATIONS(operation) ScopedAllocations shopAllocations_(ShopOperation::operation)
+#endif
+#if defined(SHOP_NO_METRICS) || defined(SHOP_NO_TRACE)
+#define SHOP_MEASURE_TRACE(operation) ((void) 0)
+#define SHOP_TRACE(name) ((void) 0)
+#else
+#define SHOP_MEASURE_TRACE(operation) \
+    TraceSpan shopSpan_(shopOperationNames[static_cast<size_t>(ShopOperation::operation)])
+#define SHOP_TRACE(name) TraceSpan SHOP_CONCAT(shopSpan_, __LINE__)(name)
+#endif
+#ifdef SHOP_NO_METRICS
+#define SHOP_MEASURE(operation) ((void) 0)
+#else
+#define SHOP_MEASURE(operation) ScopedLatency shopLatency_(ShopOperation::operation); \
+    SHOP_MEASURE_ALLOCATIONS(operation); \
+    SHOP_MEASURE_TRACE(operation)
+#endif
+
+// Стабільний 64-бітний хеш ключа для скетчів (FNV-1a з фінальним перемішуванням splitmix64);
+// не залежить від реалізації std::hash, тож збережені скетчі сумісні між збірками
+inline uint64_t sketchHash(string_view key) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c: key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+// HyperLogLog: наближена кількість різних ключів у фіксованій пам'яті (2^precision байт)
+// Стандартна похибка ~1.04 / sqrt(2^precision)
+class HyperLogLog {
+    uint8_t precision;
+    vector<uint8_t> registers;
+
+public:
+    explicit HyperLogLog(uint8_t precision = 12) : precision(precision) {
+        if (precision < 4 || precision > 18) throw invalid_argument("HyperLogLog precision must be in [4, 18].");
+        registers.resize(size_t(1) << precision);
+    }
+
+    void add(uint64_t hash) {
+        size_t index = hash >> (64 - precision);
+        uint64_t rest = hash << precision;
+        auto rank = static_cast<uint8_t>(rest == 0 ? 64 - precision + 1 : countl_zero(rest) + 1);
+        if (rank > registers[index]) registers[index] = rank;
+    }
+
+    void add(string_view key) {
+        add(sketchHash(key));
+    }
+
+    [[nodiscard]] double estimate() const {
+        double m = static_cast<double>(registers.size());
+        double sum = 0;
+        size_t zeros = 0;
+        for (uint8_t value: registers) {
+            sum += ldexp(1.0, -value);
+            zeros += value == 0;
+        }
+        double alpha = registers.size() == 16 ? 0.673
+                     : registers.size() == 32 ? 0.697
+                     : registers.size() == 64 ? 0.709
+                     : 0.7213 / (1 + 1.079 / m);
+        double raw = alpha * m * m / sum;
+        // Для малих множин точніший лінійний підрахунок порожніх регістрів
+        if (raw <= 2.5 * m && zeros > 0) return m * log(m / static_cast<double>(zeros));
+        return raw;
+    }
+
+    // Об'єднання з іншим скетчем тієї самої точності (наприклад, з іншого потоку чи шарда)
+    void merge(const HyperLogLog &other) {
+        if (other.precision != precision) throw invalid_argument("Cannot merge HyperLogLog sketches of different precision.");
+        for (size_t i = 0; i < registers.size(); ++i) {
+            registers[i] = max(registers[i], other.registers[i]);
+        }
+    }
+
+    void clear() {
+        fill(registers.begin(), registers.end(), 0);
+    }
+
+    [[nodiscard]] uint8_t getPrecision() const { return precision; }
+
+    [[nodiscard]] size_t memoryBytes() const { return registers.capacity(); }
+
+    // Текстовий формат: точність і регістри одним шістнадцятковим рядком
+    void write(ostream &out) const {
+        static constexpr char digits[] = "0123456789abcdef";
+        string hex(registers.size() * 2, '0');
+        for (size_t i = 0; i < registers.size(); ++i) {
+            hex[2 * i] = digits[registers[i] >> 4];
+            hex[2 * i + 1] = digits[registers[i] & 0xF];
+        }
+        out << int(precision) << " " << hex;
+    }
+
+    static HyperLogLog read(istream &in) {
+        int precision;
+        string hex;
+        in >> precision >> hex;
+        if (!in || precision < 4 || precision > 18) {
+            throw runtime_error("Malformed sketch section: bad HyperLogLog precision.");
+        }
+        HyperLogLog sketch(static_cast<uint8_t>(precision));
+        if (hex.size() != sketch.registers.size() * 2) {
+            throw runtime_error("Malformed sketch section: HyperLogLog register count does not match precision.");
+        }
+        // Ранг не перевищує 64 - precision + 1 (див. add)
+        unsigned maxRank = 64 - static_cast<unsigned>(precision) + 1;
+        for (size_t i = 0; i < sketch.registers.size(); ++i) {
+            const char *first = hex.data() + 2 * i;
+            unsigned value = 0;
+            auto [end, error] = from_chars(first, first + 2, value, 16);
+            if (error != errc() || end != first + 2 || value > maxRank) {
+                throw runtime_error("Malformed sketch section: bad HyperLogLog register " + to_string(i) + ".");
+            }
+            sketch.registers[i] = static_cast<uint8_t>(value);
+        }
+        return sketch;
+    }
+};
+
+// Count-Min: наближені частоти ключів; оцінка ніколи не менша за справжню частоту
+// і перевищує її не більше ніж на e/width * (сума всіх частот) з імовірністю 1 - e^-depth
+class CountMinSketch {
+    size_t width;
+    size_t depth;
+    vector<uint64_t> counters; // depth рядків по width лічильників
+
+    [[nodiscard]] size_t slot(uint64_t hash, size_t row) const {
+        auto low = static_cast<uint32_t>(hash);
+        auto high = static_cast<uint32_t>(hash >> 32) | 1;
+        return row * width + (low + row * high) % width;
+    }
+
+public:
+    explicit CountMinSketch(size_t width = 2048, size_t depth = 4) : width(width), depth(depth), counters(width * depth) {
+        if (width == 0 || depth == 0) throw invalid_argument("Count-Min sketch dimensions must be positive.");
+    }
+
+    // Додає count і повертає нову оцінку частоти ключа
+    uint64_t add(uint64_t hash, uint64_t count = 1) {
+        uint64_t result = UINT64_MAX;
+        for (size_t row = 0; row < depth; ++row) {
+            uint64_t &counter = counters[slot(hash, row)];
+            counter += count;
+            result = min(result, counter);
+        }
+        return result;
+    }
+
+    [[nodiscard]] uint64_t estimate(uint64_t hash) const {
+        uint64_t result = UINT64_MAX;
+        for (size_t row = 0; row < depth; ++row) {
+            result = min(result, counters[slot(hash, row)]);
+        }
+        return result;
+    }
+
+    void merge(const CountMinSketch &other) {
+        if (other.width != width || other.depth != depth) {
+            throw invalid_argument("Cannot merge Count-Min sketches of different dimensions.");
+        }
+        for (size_t i = 0; i < counters.size(); ++i) {
+            counters[i] += other.counters[i];
+        }
+    }
+
+    void clear() {
+        fill(counters.begin(), counters.end(), 0);
+    }
+
+    [[nodiscard]] size_t memoryBytes() const { return counters.capacity() * sizeof(uint64_t); }
+
+    void write(ostream &out) const {
+        out << width << " " << depth;
+        for (uint64_t counter: counters) {
+            out << " " << counter;
+        }
+    }
+
+    static CountMinSketch read(istream &in) {
+        size_t width, depth;
+        in >> width >> depth;
+        CountMinSketch sketch(width, depth);
+        for (uint64_t &counter: sketch.counters) {
+            in >> counter;
+        }
+        if (!in) throw runtime_error("Corrupted Count-Min sketch in file.");
+        return sketch;
+    }
+};
+
+// Потокові скетчі продажів для дашбордів: різні покупці (загалом і по моделях) та найпопулярніші моделі
+// Пам'ять не залежить від довжини історії замовлень; скетчі різних шардів можна об'єднати через merge
+class StreamingSketches {
+    static constexpr uint8_t customersPrecision = 14;      // ~0.8% похибки
+    static constexpr uint8_t modelCustomersPrecision = 8;  // ~6.5% похибки, 256 байт на модель
+
+    HyperLogLog customers{customersPrecision};
+    unordered_map<string, HyperLogLog> customersByModel;
+    CountMinSketch units;                  // Продані одиниці за моделями
+    size_t heavyCapacity;
+    unordered_map<string, uint64_t> heavy; // Кандидати в лідери -> оцінка одиниць
+    set<pair<uint64_t, string>> heavyRanking;
+
+    void offer(const string &model, uint64_t estimate) {
+        auto it = heavy.find(model);
+        if (it != heavy.end()) {
+            // Вузол рейтингу переставляється без нового виділення
+            auto node = heavyRanking.extract({it->second, model});
+            node.value().first = estimate;
+            heavyRanking.insert(std::move(node));
+            it->second = estimate;
+            return;
+        }
+        if (heavy.size() == heavyCapacity) {
+            auto weakest = heavyRanking.begin();
+            if (weakest->first >= estimate) return;
+            heavy.erase(weakest->second);
+            heavyRanking.erase(weakest);
+        }
+        heavy.emplace(model, estimate);
+        heavyRanking.emplace(estimate, model);
+    }
+
+public:
+    explicit StreamingSketches(size_t heavyCapacity = 32, size_t width = 2048, size_t depth = 4)
+            : units(width, depth), heavyCapacity(max<size_t>(heavyCapacity, 1)) {}
+
+    void record(const Order &order) {
+        uint64_t userHash = sketchHash(order.getUser());
+        customers.add(userHash);
+        for (const auto &item: order.getItems()) {
+            const string &model = item.getBike()->getModel();
+            auto perModel = customersByModel.try_emplace(model, modelCustomersPrecision).first;
+            perModel->second.add(userHash);
+            offer(model, units.add(sketchHash(model), static_cast<uint64_t>(item.getQuantity())));
+        }
+    }
+
+    // Об'єднання зі скетчами іншого шарда: лідери переоцінюються за спільним Count-Min
+    void merge(const StreamingSketches &other) {
+        customers.merge(other.customers);
+        for (const auto &[model, sketch]: other.customersByModel) {
+            customersByModel.try_emplace(model, modelCustomersPrecision).first->second.merge(sketch);
+        }
+        units.merge(other.units);
+        vector<string> candidates;
+        candidates.reserve(heavy.size() + other.heavy.size());
+        for (const auto &[model, estimate]: heavy) candidates.push_back(model);
+        for (const auto &[model, estimate]: other.heavy) candidates.push_back(model);
+        heavy.clear();
+        heavyRanking.clear();
+        for (const auto &model: candidates) {
+            offer(model, units.estimate(sketchHash(model)));
+        }
+    }
+
+    void clear() {
+        customers.clear();
+        customersByModel.clear();
+        units.clear();
+        heavy.clear();
+        heavyRanking.clear();
+    }
+
+    [[nodiscard]] double distinctCustomers() const {
+        return customers.estimate();
+    }
+
+    [[nodiscard]] double distinctCustomers(const string &model) const {
+        auto it = customersByModel.find(model);
+        return it == customersByModel.end() ? 0.0 : it->second.estimate();
+    }
+
+    [[nodiscard]] uint64_t estimateUnits(const string &model) const {
+        return units.estimate(sketchHash(model));
+    }
+
+    // До n найпопулярніших моделей за оцінкою проданих одиниць
+    [[nodiscard]] vector<pair<string, uint64_t>> heavyHitters(size_t n) const {
+        vector<pair<string, uint64_t>> result;
+        for (auto it = heavyRanking.rbegin(); it != heavyRanking.rend() && result.size() < n; ++it) {
+            result.emplace_back(it->second, it->first);
+        }
+        return result;
+    }
+
+    [[nodiscard]] size_t memoryBytes() const {
+        size_t bytes = customers.memoryBytes() + units.memoryBytes();
+        for (const auto &[model, sketch]: customersByModel) bytes += model.capacity() + sketch.memoryBytes();
+        return bytes;
+    }
+
+    void write(ostream &out) const {
+        customers.write(out);
+        out << endl << customersByModel.size() << endl;
+        for (const auto &[model, sketch]: customersByModel) {
+            out << model << " ";
+            sketch.write(out);
+            out << endl;
+        }
+        units.write(out);
+        out << endl << heavyCapacity << " " << heavy.size() << endl;
+        for (const auto &[estimate, model]: heavyRanking) {
+            out << model << " " << estimate << " ";
+        }
+        out << endl;
+    }
+
+    static StreamingSketches read(istream &in) {
+        StreamingSketches sketches;
+        sketches.customers = HyperLogLog::read(in);
+        size_t models;
+        in >> models;
+        for (size_t i = 0; i < models; ++i) {
+            string model;
+            in >> model;
+            sketches.customersByModel.insert_or_assign(model, HyperLogLog::read(in));
+        }
+        sketches.units = CountMinSketch::read(in);
+        size_t heavyCount;
+        in >> sketches.heavyCapacity >> heavyCount;
+        for (size_t i = 0; i < heavyCount; ++i) {
+            string model;
+            uint64_t estimate;
+            in >> model >> estimate;
+            sketches.offer(model, estimate);
+        }
+        if (!in) throw runtime_error("Corrupted sketches in file.");
+        return sketches;
+    }
+};
+
+// Формат вивантаження даних магазину
+enum class ExportFormat {
+    Csv,
+    Json
+};
+
+// Сторінка списку з курсором на продовження
+// Курсор - SKU для інвентарю або порядковий номер для замовлень; обидва не змінюються при додаванні
+// нових записів, тож курсор лишається дійсним між запитами
+template<typename T>
+struct Page {
+    vector<const T *> items;
+    optional<uint64_t> next; // Курсор наступної сторінки; порожній, якщо список вичерпано
+};
+
+// Оцінка пам'яті магазину за частинами, байти
+struct MemoryUsage {
+    size_t inventory = 0;  // Масив позицій інвентаря
+    size_t bikes = 0;      // Об'єкти велосипедів: інвентар і власні копії позицій завантажених замовлень
+    size_t orders = 0;     // Об'єкти замовлень і масив вказівників на них
+    size_t orderLines = 0; // Масиви позицій замовлень
+    size_t strings = 0;    // Назви моделей, підвісок і імена покупців понад вбудований буфер рядка
+    size_t indexes = 0;    // Пошук за назвою і SKU, каталог, словник назв, нестача, покупці
+    size_t analytics = 0;  // Статистика продажів, часові кошики, скетчі
+    size_t snapshots = 0;  // Опублікована версія інвентарю з копіями велосипедів
+
+    [[nodiscard]] size_t total() const {
+        return inventory + bikes + orders + orderLines + strings + indexes + analytics + snapshots;
+    }
+
+    void write(ReportWriter &out) const {
+        out << "inventory " << inventory << "\nbikes " << bikes << "\norders " << orders << "\norder_lines "
+            << orderLines << "\nstrings " << strings << "\nindexes " << indexes << "\nanalytics " << analytics
+            << "\nsnapshots " << snapshots << "\ntotal " << total() << '\n';
+        out.flush();
+    }
+};
+
+// Відкладене звільнення даних, які читають без блокувань (епохи читачів)
+// Читач закріплює поточну епоху на час читання: це один запис у власний рядок кешу потоку, тож
+// читачі на різних ядрах не заважають одне одному. Письменник, опублікувавши нові дані, передає
+// замінені об'єкти в retire(); вони звільняються, коли не лишиться читачів, закріплених до заміни
+class EpochDomain {
+public:
+    // Об'єкт, що чекає на звільнення
+    struct Garbage {
+        const void *object;
+        void (*destroy)(const void *);
+    };
+
+    template<typename T>
+    static Garbage garbage(const T *object) {
+        return {object, [](const void *pointer) { delete static_cast<const T *>(pointer); }};
+    }
+
+private:
+    static constexpr uint64_t quiescent = 0;
+    static constexpr size_t collectThreshold = 1024; // Відкладених об'єктів до першої спроби звільнення
+
+    // Власний рядок кешу для кожного потоку
+    struct alignas(64) Participant {
+        atomic<uint64_t> epoch{quiescent};
+        bool used = true;
+    };
+
+    struct Retired {
+        Garbage garbage;
+        uint64_t epoch;
+    };
+
+    struct Registry {
+        mutex lock;
+        vector<unique_ptr<Participant>> participants; // Записи завершених потоків дістаються новим потокам
+        vector<Retired> retired;
+        size_t nextCollect = collectThreshold;
+
+        ~Registry() {
+            for (const auto &entry: retired) entry.garbage.destroy(entry.garbage.object);
+        }
+    };
+
+    static Registry &registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    struct ThreadState {
+        Participant *participant = nullptr;
+        size_t depth = 0; // Вкладені закріплення
+
+        ThreadState() {
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            for (const auto &candidate: shared.participants) {
+                if (!candidate->used) {
+                    candidate->used = true;
+                    participant = candidate.get();
+                    return;
+                }
+            }
+            shared.participants.push_back(make_unique<Participant>());
+            participant = shared.participants.back().get();
+        }
+
+        ~ThreadState() {
+            Registry &shared = registry();
+            lock_guard<mutex> guard(shared.lock);
+            participant->epoch.store(quiescent, memory_order_release);
+            participant->used = false;
+        }
+    };
+
+    static ThreadState &registerThread() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    static ThreadState &local() {
+        static thread_local ThreadState *state = nullptr;
+        if (!state) [[unlikely]] state = &registerThread();
+        return *state;
+    }
+
+    static inline atomic<uint64_t> globalEpoch{1};
+
+    // Звільнення об'єктів, замінених раніше за найстарішу закріплену епоху; під блокуванням реєстру
+    static void collectLocked(Registry &shared) {
+        uint64_t oldest = UINT64_MAX;
+        for (const auto &participant: shared.participants) {
+            uint64_t epoch = participant->epoch.load(memory_order_seq_cst);
+            if (epoch != quiescent) oldest = min(oldest, epoch);
+        }
+        auto alive = partition(shared.retired.begin(), shared.retired.end(),
+                               [oldest](const Retired &entry) { return entry.epoch >= oldest; });
+        for (auto it = alive; it != shared.retired.end(); ++it) it->garbage.destroy(it->garbage.object);
+        shared.retired.erase(alive, shared.retired.end());
+        // Довгі читачі затримують звільнення; поріг росте, щоб не перебирати той самий список щоразу
+        shared.nextCollect = max(collectThreshold, shared.retired.size() * 2);
+    }
+
+public:
+    // Закріплення епохи на час життя об'єкта; вкладені закріплення одного потоку дозволені
+    // Спільні вказівники під закріпленням читаються з memory_order_seq_cst; Guard не передається між потоками
+    class Guard {
+        ThreadState &state;
+
+    public:
+        Guard() : state(local()) {
+            if (state.depth++ == 0) {
+                state.participant->epoch.store(globalEpoch.load(memory_order_seq_cst), memory_order_seq_cst);
+            }
+        }
+
+        ~Guard() {
+            if (--state.depth == 0) state.participant->epoch.store(quiescent, memory_order_release);
+        }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+    };
+
+    // Передача замінених об'єктів; нові дані мають бути вже опубліковані записом memory_order_seq_cst
+    static void retire(vector<Garbage> &objects) {
+        if (objects.empty()) return;
+        uint64_t epoch = globalEpoch.fetch_add(1, memory_order_seq_cst);
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        for (const auto &object: objects) shared.retired.push_back({object, epoch});
+        objects.clear();
+        if (shared.retired.size() >= shared.nextCollect) collectLocked(shared);
+    }
+
+    static void collect() {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        collectLocked(shared);
+    }
+
+    [[nodiscard]] static size_t pending() {
+        Registry &shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        return shared.retired.size();
+    }
+};
+
+// Масив, що копіюється під час запису: сторінки по leafSize елементів, каталоги по branchSize сторінок
+// Зміна елемента копіює лише його сторінку і каталог, решта вузлів спільна з попередніми версіями
+template<typename T>
+struct PersistentSlots {
+    static constexpr size_t leafSize = 32;
+    static constexpr size_t branchSize = 128;
+    static constexpr size_t branchSpan = leafSize * branchSize;
+
+    struct Leaf {
+        array<T, leafSize> slots{};
+        uint64_t generation = 0; // Чернетка, що створила вузол; лише вона змінює його на місці
+    };
+
+    struct Branch {
+        array<Leaf *, branchSize> leaves{};
+        uint64_t generation = 0;
+    };
+
+    vector<Branch *> root;
+
+    // nullptr, якщо сторінку ще не створено
+    [[nodiscard]] const T *get(size_t index) const {
+        if (index / branchSpan >= root.size()) return nullptr;
+        const Leaf *leaf = root[index / branchSpan]->leaves[index / leafSize % branchSize];
+        return leaf ? &leaf->slots[index % leafSize] : nullptr;
+    }
+
+    // Перебір наявних елементів [from, to) до першого false від visit(індекс, елемент)
+    template<typename F>
+    void scan(size_t from, size_t to, F visit) const {
+        for (size_t index = from; index < to && index / branchSpan < root.size();) {
+            const Leaf *leaf = root[index / branchSpan]->leaves[index / leafSize % branchSize];
+            size_t leafEnd = min(to, (index / leafSize + 1) * leafSize);
+            for (; leaf && index < leafEnd; ++index) {
+                if (!visit(index, leaf->slots[index % leafSize])) return;
+            }
+            index = leafEnd;
+        }
+    }
+
+    // Елемент для зміни чернеткою generation; замінені вузли додаються до garbage
+    T &edit(size_t index, uint64_t generation, vector<EpochDomain::Garbage> &garbage) {
+        while (root.size() <= index / branchSpan) {
+            root.push_back(new Branch());
+            root.back()->generation = generation;
+        }
+        Branch *&branch = root[index / branchSpan];
+        if (branch->generation != generation) {
+            auto *copy = new Branch(*branch);
+            copy->generation = generation;
+            garbage.push_back(EpochDomain::garbage(branch));
+            branch = copy;
+        }
+        Leaf *&leaf = branch->leaves[index / leafSize % branchSize];
+        if (!leaf) {
+            leaf = new Leaf();
+            leaf->generation = generation;
+        } else if (leaf->generation != generation) {
+            auto *copy = new Leaf(*leaf);
+            copy->generation = generation;
+            garbage.push_back(EpochDomain::garbage(leaf));
+            leaf = copy;
+        }
+        return leaf->slots[index % leafSize];
+    }
+
+    // Від'єднання всіх вузлів; вони додаються до garbage
+    void release(vector<EpochDomain::Garbage> &garbage) {
+        for (Branch *branch: root) {
+            for (Leaf *leaf: branch->leaves) {
+                if (leaf) garbage.push_back(EpochDomain::garbage(leaf));
+            }
+            garbage.push_back(EpochDomain::garbage(branch));
+        }
+        root.clear();
+    }
+
+    [[nodiscard]] size_t memoryBytes() const {
+        size_t bytes = heapBytes(root) + root.size() * sizeof(Branch);
+        for (const Branch *branch: root) {
+            bytes += sizeof(Leaf) * static_cast<size_t>(count_if(branch->leaves.begin(), branch->leaves.end(),
+                                                                 [](const Leaf *leaf) { return leaf != nullptr; }));
+        }
+        return bytes;
+    }
+};
+
+// Запис опублікованої версії інвентарю
+struct CatalogRecord {
+    const Bike *bike = nullptr; // Власна незмінна копія велосипеда; nullptr - SKU видалено
+    uint32_t sku = 0;
+    int quantity = 0;
+    int reserved = 0;
+
+    [[nodiscard]] int getAvailable() const { return quantity - reserved; }
+};
+
+// Незмінна версія інвентарю: записи за SKU і таблиця назв з відкритою адресацією
+struct CatalogVersion {
+    static constexpr uint32_t emptySlot = UINT32_MAX;
+    static constexpr uint32_t erasedSlot = UINT32_MAX - 1;
+
+    struct NameSlot {
+        size_t nameHash = 0;
+        uint32_t sku = emptySlot;
+    };
+
+    PersistentSlots<CatalogRecord> records;
+    PersistentSlots<NameSlot> names;
+    size_t nameCapacity = 0; // Степінь двійки; зайняті й видалені комірки - не більше половини
+    size_t nameUsed = 0;     // Зайняті й видалені комірки
+    size_t bikes = 0;
+    size_t skus = 0;         // Межа SKU для перебору записів
+    uint64_t generation = 0;
+
+    [[nodiscard]] const CatalogRecord *find(string_view model) const {
+        if (nameCapacity == 0) return nullptr;
+        size_t key = std::hash<string_view>{}(model);
+        for (size_t i = key & (nameCapacity - 1);; i = (i + 1) & (nameCapacity - 1)) {
+            const NameSlot &slot = *names.get(i);
+            if (slot.sku == emptySlot) return nullptr;
+            if (slot.sku != erasedSlot && slot.nameHash == key) {
+                const CatalogRecord *record = records.get(slot.sku);
+                if (record->bike->getModel() == model) return record;
+            }
+        }
+    }
+
+    [[nodiscard]] const CatalogRecord *findSku(uint64_t sku) const {
+        if (sku >= skus) return nullptr;
+        const CatalogRecord *record = records.get(sku);
+        return record && record->bike ? record : nullptr;
+    }
+};
+
+// Публікація версій інвентарю для читачів без блокувань
+// Зміни пишуться в чернетку (копію кореня поточної версії) і публікуються заміною атомарного вказівника;
+// Batch об'єднує кілька змін в одну версію. Письменник один - виклики змін упорядковує власник
+class CatalogVersions {
+    atomic<CatalogVersion *> current{new CatalogVersion()};
+    CatalogVersion *draft = nullptr;
+    size_t batchDepth = 0;
+    uint64_t generation = 0;
+    vector<EpochDomain::Garbage> garbage; // Замінене чернеткою
+
+    void begin() {
+        if (batchDepth > 0) {
+            ++batchDepth;
+            return;
+        }
+        draft = new CatalogVersion(*current.load(memory_order_relaxed));
+        draft->generation = ++generation;
+        batchDepth = 1;
+    }
+
+    void publish() {
+        if (--batchDepth > 0) return;
+        CatalogVersion *previous = current.load(memory_order_relaxed);
+        current.store(draft, memory_order_seq_cst);
+        draft = nullptr;
+        garbage.push_back(EpochDomain::garbage(previous));
+        EpochDomain::retire(garbage);
+    }
+
+    static Bike *copyBike(const Bike &bike) {
+        if (auto mountain = dynamic_cast<const MountainBike *>(&bike)) {
+            return new MountainBike(const_cast<MountainBike *>(mountain));
+        }
+        return new RoadBike(const_cast<RoadBike *>(dynamic_cast<const RoadBike *>(&bike)));
+    }
+
+    CatalogRecord &editRecord(uint32_t sku) {
+        return draft->records.edit(sku, draft->generation, garbage);
+    }
+
+    // Вставка без перевірки повторів: назви в інвентарі унікальні
+    void placeName(size_t key, uint32_t sku) {
+        size_t mask = draft->nameCapacity - 1;
+        for (size_t i = key & mask;; i = (i + 1) & mask) {
+            const CatalogVersion::NameSlot &slot = *draft->names.get(i);
+            if (slot.sku == CatalogVersion::emptySlot || slot.sku == CatalogVersion::erasedSlot) {
+                if (slot.sku == CatalogVersion::emptySlot) ++draft->nameUsed;
+                draft->names.edit(i, draft->generation, garbage) = {key, sku};
+                return;
+            }
+        }
+    }
+
+    // Нова таблиця назв з запасом щонайменше вчетверо; видалені комірки відкидаються
+    void rebuildNames() {
+        draft->names.release(garbage);
+        draft->nameCapacity = bit_ceil(max<size_t>(64, draft->bikes * 4));
+        draft->nameUsed = 0;
+        for (size_t i = 0; i < draft->nameCapacity; i += PersistentSlots<CatalogVersion::NameSlot>::leafSize) {
+            draft->names.edit(i, draft->generation, garbage);
+        }
+        draft->records.scan(0, draft->skus, [this](size_t sku, const CatalogRecord &record) {
+            if (record.bike) placeName(std::hash<string_view>{}(record.bike->getModel()), static_cast<uint32_t>(sku));
+            return true;
+        });
+    }
+
+public:
+    // Зміни в межах об'єкта публікуються однією версією під час його знищення
+    class Batch {
+        CatalogVersions &versions;
+
+    public:
+        explicit Batch(CatalogVersions &versions) : versions(versions) { versions.begin(); }
+
+        ~Batch() { versions.publish(); }
+
+        Batch(const Batch &) = delete;
+        Batch &operator=(const Batch &) = delete;
+    };
+
+    CatalogVersions() = default;
+
+    CatalogVersions(const CatalogVersions &) = delete;
+    CatalogVersions &operator=(const CatalogVersions &) = delete;
+
+    // Знімки мають бути знищені раніше
+    ~CatalogVersions() {
+        CatalogVersion *last = current.load(memory_order_relaxed);
+        last->records.scan(0, last->skus, [this](size_t, const CatalogRecord &record) {
+            if (record.bike) garbage.push_back(EpochDomain::garbage(record.bike));
+            return true;
+        });
+        last->records.release(garbage);
+        last->names.release(garbage);
+        garbage.push_back(EpochDomain::garbage(last));
+        for (const auto &object: garbage) object.destroy(object.object);
+    }
+
+    // Поточна версія; викликається під EpochDomain::Guard
+    [[nodiscard]] const CatalogVersion *acquire() const {
+        return current.load(memory_order_seq_cst);
+    }
+
+    // Новий велосипед або нова копія зміненого
+    void put(uint32_t sku, const Bike &bike, int quantity, int reserved) {
+        Batch batch(*this);
+        Bike *copy = copyBike(bike);
+        CatalogRecord &record = editRecord(sku);
+        bool added = !record.bike;
+        if (!added) garbage.push_back(EpochDomain::garbage(record.bike));
+        record = {copy, sku, quantity, reserved};
+        draft->skus = max<size_t>(draft->skus, size_t(sku) + 1);
+        if (!added) return;
+        ++draft->bikes;
+        if ((draft->nameUsed + 1) * 2 > draft->nameCapacity) rebuildNames();
+        else placeName(std::hash<string_view>{}(copy->getModel()), sku);
+    }
+
+    void setStock(uint32_t sku, int quantity, int reserved) {
+        Batch batch(*this);
+        CatalogRecord &record = editRecord(sku);
+        record.quantity = quantity;
+        record.reserved = reserved;
+    }
+
+    void erase(uint32_t sku) {
+        Batch batch(*this);
+        CatalogRecord &record = editRecord(sku);
+        if (!record.bike) return;
+        size_t mask = draft->nameCapacity - 1;
+        for (size_t i = std::hash<string_view>{}(record.bike->getModel()) & mask;; i = (i + 1) & mask) {
+            if (draft->names.get(i)->sku == sku) {
+                draft->names.edit(i, draft->generation, garbage).sku = CatalogVersion::erasedSlot;
+                break;
+            }
+        }
+        garbage.push_back(EpochDomain::garbage(record.bike));
+        record.bike = nullptr;
+        --draft->bikes;
+    }
+
+    void clear() {
+        Batch batch(*this);
+        draft->records.scan(0, draft->skus, [this](size_t, const CatalogRecord &record) {
+            if (record.bike) garbage.push_back(EpochDomain::garbage(record.bike));
+            return true;
+        });
+        draft->records.release(garbage);
+        draft->names.release(garbage);
+        draft->nameCapacity = draft->nameUsed = draft->bikes = draft->skus = 0;
+    }
+
+    // Поточна версія разом з копіями велосипедів; старі версії, що чекають звільнення, не враховуються
+    [[nodiscard]] size_t memoryBytes() const {
+        const CatalogVersion *version = current.load(memory_order_relaxed);
+        size_t bytes = sizeof(CatalogVersion) + version->records.memoryBytes() + version->names.memoryBytes();
+        version->records.scan(0, version->skus, [&bytes](size_t, const CatalogRecord &record) {
+            if (auto mountain = dynamic_cast<const MountainBike *>(record.bike)) {
+                bytes += sizeof(MountainBike) + heapBytes(mountain->getSuspensionModel());
+            } else if (record.bike) {
+                bytes += sizeof(RoadBike);
+            }
+            if (record.bike) bytes += heapBytes(record.bike->getModel());
+            return true;
+        });
+        return bytes;
+    }
+};
+
+// Узгоджений знімок інвентарю для читання без блокувань, зокрема з інших потоків під час змін магазину
+// Записи й велосипеди знімка не змінюються і живуть, доки існує знімок; знімок не передається між потоками
+// Довгі знімки затримують звільнення старих версій
+class CatalogSnapshot {
+    EpochDomain::Guard guard; // Оголошений першим: епоха закріплюється до читання версії
+    const CatalogVersion *version;
+
+public:
+    explicit CatalogSnapshot(const CatalogVersions &versions) : version(versions.acquire()) {}
+
+    [[nodiscard]] size_t size() const { return version->bikes; }
+
+    [[nodiscard]] bool empty() const { return version->bikes == 0; }
+
+    [[nodiscard]] const CatalogRecord *find(string_view model) const { return version->find(model); }
+
+    [[nodiscard]] const CatalogRecord *findSku(uint64_t sku) const { return version->findSku(sku); }
+
+    // Записи в порядку SKU
+    template<typename F>
+    void forEach(F visit) const {
+        version->records.scan(0, version->skus, [&visit](size_t, const CatalogRecord &record) {
+            if (record.bike) visit(record);
+            return true;
+        });
+    }
+
+    // Сторінка з курсором, як у Shop::pageInventory
+    [[nodiscard]] Page<CatalogRecord> page(uint64_t cursor, size_t pageSize) const {
+        if (pageSize == 0) throw invalid_argument("Page size must be positive.");
+        Page<CatalogRecord> page;
+        page.items.reserve(pageSize);
+        version->records.scan(min<uint64_t>(cursor, version->skus), version->skus,
+                              [&page, pageSize](size_t sku, const CatalogRecord &record) {
+                                  if (!record.bike) return true;
+                                  if (page.items.size() == pageSize) {
+                                      page.next = sku;
+                                      return false;
+                                  }
+                                  page.items.push_back(&record);
+                                  return true;
+                              });
+        return page;
+    }
+
+    void render(ReportWriter &out) const {
+        if (empty()) {
+            out << "Inventory is empty." << '\n';
+        } else {
+            out << "Inventory: " << '\n';
+            forEach([&out](const CatalogRecord &record) {
+                record.bike->render(out);
+                out << "Quantity: " << record.quantity << '\n';
+                out << "-----------------------------" << '\n';
+            });
+        }
+        out.flush();
+    }
+};
+
+// Магазин
+class Shop : private BikeObserver {
+private:
+    vector<InventoryItem> inventory; // Інвентар магазину
+    vector<unique_ptr<Order>> orders; // Замовлення магазину
+    unordered_map<string, size_t> modelIndex; // Модель -> позиція в інвентарі
+    vector<size_t> skuSlots;                  // SKU -> позиція в інвентарі (npos для видалених)
+    CatalogIndex catalog;                     // Бітові індекси атрибутів каталогу
+    ModelNameIndex modelNames;                // Префіксний словник назв моделей
+    SalesAnalytics sales;                     // Статистика продажів за моделями
+    SalesTimeline timeline;                   // Продажі за часовими кошиками
+    StreamingSketches sketches;               // Наближені лічильники для дашбордів
+    LowStockWatch lowStock;                   // Моделі із запасом нижче порогу
+    unordered_map<string, CustomerStats> customers; // Покупець -> його замовлення
+    CatalogVersions catalogVersions;          // Опубліковані версії інвентарю для читачів без блокувань
+    mutable mutex driverMutex;                // Замок багатопотокових обробників магазину
+    static int totalSoldItems;
+    static double totalRevenue;
+    static constexpr int dataFormatVersion = 3; // Версія формату файлу даних
+
+public:
+
+
+    Shop() {
+        // Оцінки підказок автодоповнення: доступний запас або продані одиниці моделі
+        modelNames.setScorer([this](CompletionRank rank, uint32_t sku, string_view name) {
+            if (rank == CompletionRank::Sales) {
+                const ModelSales *stats = sales.get(string(name));
+                return stats ? static_cast<double>(stats->units) : 0.0;
+            }
+            if (sku >= skuSlots.size() || skuSlots[sku] == string::npos) return 0.0;
+            return static_cast<double>(inventory[skuSlots[sku]].getAvailable());
+        });
+    }
+
+    Shop(const Shop &) = delete;
+    Shop &operator=(const Shop &) = delete;
+
+private:
+    InventoryItem *findItem(const string &model) {
+        auto it = modelIndex.find(model);
+        return it == modelIndex.end() ? nullptr : &inventory[it->second];
+    }
+
+    // Оновлення індексу для позицій, починаючи з from
+    void reindexFrom(size_t from) {
+        for (size_t i = from; i < inventory.size(); ++i) {
+            modelIndex[inventory[i].getBike()->getModel()] = i;
+            skuSlots[inventory[i].getSku()] = i;
+        }
+    }
+
+    // Реєстрація щойно доданої останньої позиції інвентарю в індексах
+    void indexLastItem() {
+        InventoryItem &item = inventory.back();
+        item.setSku(static_cast<uint32_t>(skuSlots.size()));
+        skuSlots.push_back(inventory.size() - 1);
+        modelIndex[item.getBike()->getModel()] = inventory.size() - 1;
+        catalog.add(item.getSku(), *item.getBike(), item.getAvailable() > 0);
+        modelNames.add(item.getBike()->getModel(), item.getSku());
+        catalogVersions.put(item.getSku(), *item.getBike(), item.getQuantity(), item.getReserved());
+        item.getBike()->setObserver(this);
+    }
+
+    // Велосипеди інвентарю повідомляють про зміни, щоб індекси лишались актуальними
+    void onBikeChanged(const Bike &bike, BikeField field, double oldValue) override {
+        if (InventoryItem *item = findItem(bike.getModel())) {
+            catalog.update(item->getSku(), bike, field, oldValue);
+            catalogVersions.put(item->getSku(), bike, item->getQuantity(), item->getReserved());
+        }
+    }
+
+    static const char *typeName(BikeType type) {
+        return type == BikeType::Mountain ? "mountain" : "road";
+    }
+
+    static const char *typeName(OrderType type) {
+        switch (type) {
+            case OrderType::FixedDiscount:
+                return "fixed_discount";
+            case OrderType::ProgressiveDiscount:
+                return "progressive_discount";
+            default:
+                return "standard";
+        }
+    }
+
+    static void writeInventoryRecord(ReportWriter &out, const InventoryItem &item, ExportFormat format, size_t index) {
+        const Bike &bike = *item.getBike();
+        auto mountain = dynamic_cast<const MountainBike *>(&bike);
+        auto road = dynamic_cast<const RoadBike *>(&bike);
+        if (format == ExportFormat::Csv) {
+            out << item.getSku() << ',';
+            out.csv(bike.getModel()) << ',' << typeName(bike.getType()) << ',';
+            out.exact(bike.getFrameSize()) << ',';
+            out.exact(bike.getWheelSize()) << ',' << bike.getGearCount() << ',';
+            out.exact(bike.getPrice()) << ',' << item.getQuantity() << ',' << item.getReserved() << ',';
+            if (mountain) {
+                out.csv(mountain->getSuspensionModel())
+                        << (mountain->getSuspensionType() == SuspensionType::Hardtail ? ",hardtail," : ",full,");
+            } else {
+                out << ",,";
+            }
+            if (road) out << static_cast<int>(road->getAerodynamics());
+            out << '\n';
+            return;
+        }
+        out << (index == 0 ? "\n" : ",\n") << "{\"sku\":" << item.getSku() << ",\"model\":";
+        out.json(bike.getModel()) << ",\"type\":\"" << typeName(bike.getType()) << "\",\"frame_size\":";
+        out.exact(bike.getFrameSize()) << ",\"wheel_size\":";
+        out.exact(bike.getWheelSize()) << ",\"gear_count\":" << bike.getGearCount() << ",\"price\":";
+        out.exact(bike.getPrice()) << ",\"quantity\":" << item.getQuantity() << ",\"reserved\":" << item.getReserved();
+        if (mountain) {
+            out << ",\"suspension_model\":";
+            out.json(mountain->getSuspensionModel()) << ",\"suspension_type\":\""
+                    << (mountain->getSuspensionType() == SuspensionType::Hardtail ? "hardtail" : "full") << '"';
+        }
+        if (road) out << ",\"aerodynamics\":" << static_cast<int>(road->getAerodynamics());
+        out << '}';
+    }
+
+    static void writeOrderRecord(ReportWriter &out, const Order &order, ExportFormat format, size_t ordinal) {
+        double subtotal = order.getSubtotal();
+        double total = order.calculateTotalPrice();
+        if (format == ExportFormat::Csv) {
+            for (const auto &item: order.getItems()) {
+                out << ordinal << ',' << order.getSoldAt() << ',';
+                out.csv(order.getUser()) << ',' << typeName(order.getType()) << ',';
+                out.csv(item.getBike()->getModel()) << ',' << item.getQuantity() << ',';
+                out.exact(item.getTotalPrice()) << ',';
+                out.exact(subtotal) << ',';
+                out.exact(total) << '\n';
+            }
+            return;
+        }
+        out << (ordinal == 0 ? "\n" : ",\n") << "{\"order\":" << ordinal << ",\"sold_at\":" << order.getSoldAt()
+            << ",\"user\":";
+        out.json(order.getUser()) << ",\"order_type\":\"" << typeName(order.getType()) << "\",\"subtotal\":";
+        out.exact(subtotal) << ",\"total\":";
+        out.exact(total) << ",\"items\":[";
+        bool first = true;
+        for (const auto &item: order.getItems()) {
+            out << (first ? "" : ",") << "{\"model\":";
+            out.json(item.getBike()->getModel()) << ",\"quantity\":" << item.getQuantity() << ",\"line_total\":";
+            out.exact(item.getTotalPrice()) << '}';
+            first = false;
+        }
+        out << "]}";
+    }
+
+    // Форматування записів частинами по кілька тисяч у кількох потоках; частини віддаються приймачу
+    // строго по порядку. Поки записується один раунд частин, потоки форматують наступний, тож у пам'яті
+    // не більше двох раундів незалежно від кількості записів
+    template<typename Format>
+    static void formatChunked(size_t count, ReportSink &sink, unsigned threadCount, Format format) {
+        constexpr size_t chunkRecords = 4096;
+        if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+        size_t chunks = (count + chunkRecords - 1) / chunkRecords;
+        size_t threads = min<size_t>(threadCount, chunks);
+        if (threads <= 1) {
+            ReportWriter out(sink);
+            for (size_t i = 0; i < count; ++i) {
+                format(out, i);
+            }
+            out.flush();
+            return;
+        }
+
+        array<vector<string>, 2> parts{vector<string>(threads), vector<string>(threads)};
+        array<vector<exception_ptr>, 2> errors{vector<exception_ptr>(threads), vector<exception_ptr>(threads)};
+        auto launch = [&](size_t round) {
+            vector<thread> workers;
+            auto &roundParts = parts[round % 2];
+            auto &roundErrors = errors[round % 2];
+            for (size_t part = 0; part < threads; ++part) {
+                size_t begin = (round * threads + part) * chunkRecords;
+                roundParts[part].clear();
+                roundErrors[part] = nullptr;
+                if (begin >= count) continue;
+                size_t end = min(count, begin + chunkRecords);
+                workers.emplace_back([&, part, begin, end] {
+                    try {
+                        StringSink chunkSink(roundParts[part]);
+                        ReportWriter out(chunkSink);
+                        for (size_t i = begin; i < end; ++i) {
+                            format(out, i);
+                        }
+                        out.flush();
+                    } catch (...) {
+                        roundErrors[part] = current_exception();
+                    }
+                });
+            }
+            return workers;
+        };
+        auto join = [](vector<thread> &workers) {
+            for (auto &worker: workers) {
+                worker.join();
+            }
+            workers.clear();
+        };
+
+        size_t rounds = (chunks + threads - 1) / threads;
+        vector<thread> running = launch(0);
+        for (size_t round = 0; round < rounds; ++round) {
+            join(running);
+            for (auto &error: errors[round % 2]) {
+                if (error) rethrow_exception(error);
+            }
+            if (round + 1 < rounds) running = launch(round + 1);
+            try {
+                for (const auto &part: parts[round % 2]) {
+                    if (!part.empty()) sink.write(part);
+                }
+            } catch (...) {
+                join(running);
+                throw;
+            }
+        }
+    }
+
+    template<typename Export>
+    static void exportToFile(const string &file, Export exportTo) {
+        FILE *output = fopen(file.c_str(), "wb");
+        if (!output) throw runtime_error("Failed to open file for writing.");
+        try {
+            FileSink sink(output);
+            exportTo(sink);
+        } catch (...) {
+            fclose(output);
+            throw;
+        }
+        if (fclose(output) != 0) throw runtime_error("Failed to write export file.");
+    }
+
+    void refreshStock(const InventoryItem &item) {
+        catalog.setInStock(item.getSku(), item.getAvailable() > 0);
+        modelNames.refresh(item.getSku());
+        catalogVersions.setStock(item.getSku(), item.getQuantity(), item.getReserved());
+    }
+
+public:
+
+    // Додавання нового велосипеда
+    void addBike(Bike *bike, int quantity = 1) {
+        SHOP_MEASURE(AddBike);
+        if (quantity < 0) throw invalid_argument("Quantity must be positive or 0.");
+
+        // Перевірка наявності велосипеда у інвентарі
+        if (modelIndex.count(bike->getModel())) {
+            throw runtime_error("Bike already exists in inventory.");
+        }
+        shared_ptr<Bike> bikecopy;
+        if (bike->getType() == BikeType::Mountain)
+            bikecopy = make_shared<MountainBike>(dynamic_cast<MountainBike *>(bike));
+        else {
+            bikecopy = make_shared<RoadBike>(dynamic_cast<RoadBike *>(bike));
+        }
+        inventory.emplace_back(std::move(bikecopy), quantity, &lowStock);
+        indexLastItem();
+        cout << "Bike added successfully!" << endl;
+    }
+
+    void restockBike(const string &model, int quantity) {
+        SHOP_MEASURE(RestockBike);
+        if (quantity <= 0) throw invalid_argument("Quantity must be positive.");
+        InventoryItem *item = findItem(model);
+        if (!item) throw runtime_error("Bike with the specified model not found in inventory.");
+        item->increaseQuantity(quantity);
+        refreshStock(*item);
+        cout << "Bike restocked successfully!" << endl;
+    }
+
+
+    // Пошук велосипеда за моделлю
+    Bike *findBikeByModel(const string &model) {
+        SHOP_MEASURE(FindBikeByModel);
+        InventoryItem *item = findItem(model);
+        return item ? item->getBike() : nullptr;
+    }
+
+    // Замок, під яким багатопотокові обробники (OrderIntake, OrderPipeline) викликають магазин
+    // Він один на магазин, тож кілька обробників можуть працювати з тим самим магазином одночасно
+    [[nodiscard]] mutex &operationMutex() const {
+        return driverMutex;
+    }
+
+    // Знімок інвентарю для читання без блокувань: його можна брати з будь-яких потоків одночасно
+    // зі змінами магазину, якщо самі зміни (addBike, shipOrder, editBike...) виконує один потік за раз
+    // Кожна зміна публікує нову версію, копіюючи лише сторінки змінених записів
+    [[nodiscard]] CatalogSnapshot catalogSnapshot() const {
+        return CatalogSnapshot(catalogVersions);
+    }
+
+    // Редагування велосипеда за моделлю
+    void editBike(const string &model) {
+        SHOP_MEASURE(EditBike);
+        InventoryItem *item = findItem(model);
+        if (!item) throw runtime_error("Bike with the specified model not found in inventory.");
+
+        cout << "Choose field to edit:\n1. Frame Size\n2. Wheel Size\n3. Gear Count\n4. Price\n";
+        int choice;
+        cin >> choice;
+
+        double newValue;
+        int newIntValue;
+        switch (choice) {
+            case 1:
+                cout << "Enter new frame size: ";
+                cin >> newValue;
+                item->getBike()->setFrameSize(newValue);
+                break;
+            case 2:
+                cout << "Enter new wheel size: ";
+                cin >> newValue;
+                item->getBike()->setWheelSize(newValue);
+                break;
+            case 3:
+                cout << "Enter new gear count: ";
+                cin >> newIntValue;
+                item->getBike()->setGearCount(newIntValue);
+                break;
+            case 4:
+                cout << "Enter new price: ";
+                cin >> newValue;
+                item->getBike()->setPrice(newValue);
+                break;
+            default:
+                cout << "Invalid choice." << endl;
+                return;
+        }
+        cout << "Bike updated successfully!" << endl;
+    }
+
+    // Видалення велосипеда за моделлю
+    void removeBike(const string &model) {
+        SHOP_MEASURE(RemoveBike);
+        auto found = modelIndex.find(model);
+        if (found == modelIndex.end()) {
+            throw runtime_error("Bike with the specified model not found in inventory.");
+        }
+
+        size_t position = found->second;
+        auto it = inventory.begin() + static_cast<ptrdiff_t>(position);
+        modelIndex.erase(model);
+        skuSlots[it->getSku()] = string::npos;
+        catalog.remove(it->getSku(), *it->getBike());
+        modelNames.remove(model, it->getSku());
+        catalogVersions.erase(it->getSku());
+        lowStock.forget(model, it->getHeadroom());
+        // Велосипед звільниться разом з останнім рядком замовлення, що на нього посилається
+        it->getBike()->setObserver(nullptr);
+        inventory.erase(it); // Видалення елемента з інвентарю
+        reindexFrom(position);
+        cout << "Bike removed successfully!" << endl;
+    }
+
+
+    // Звіт про інвентар у довільний приймач
+    // Виводиться опублікована версія, тож виклик не заважає одночасним змінам магазину
+    void renderInventory(ReportWriter &out) const {
+        catalogSnapshot().render(out);
+    }
+
+    // Виведення всіх велосипедів в інвентарі
+    void displayInventory() const {
+        SHOP_MEASURE(DisplayInventory);
+        StreamSink sink(cout);
+        ReportWriter out(sink);
+        renderInventory(out);
+    }
+
+    bool checkInventoryForOrder(const Order *order) {
+        SHOP_MEASURE(CheckInventoryForOrder);
+        for (const auto &orderItem: order->getItems()) {
+            InventoryItem *inventoryItem = findItem(orderItem.getBike()->getModel());
+            // Якщо хоча б для одного товару недостатньо вільної кількості
+            if (!inventoryItem || inventoryItem->getAvailable() < orderItem.getQuantity()) return false;
+        }
+        return true; // Всі велосипеди є в потрібній кількості
+    }
+
+    // Відправка замовлення; магазин забирає його у свою історію
+    void shipOrder(unique_ptr<Order> order) {
+        SHOP_MEASURE(ShipOrder);
+        if (!order) throw invalid_argument("Order must not be null.");
+        if (!checkInventoryForOrder(order.get())) {
+            throw runtime_error("Not enough bikes in inventory to fulfill the order.");
+        }
+
+        // Якщо кількість достатня, зменшуємо кількість у інвентарі
+        {
+            SHOP_TRACE("shipOrder.decreaseStock");
+            CatalogVersions::Batch publish(catalogVersions);
+            for (const auto &orderItem: order->getItems()) {
+                InventoryItem *item = findItem(orderItem.getBike()->getModel());
+                item->decreaseQuantity(orderItem.getQuantity());
+                refreshStock(*item);
+            }
+        }
+
+        totalSoldItems += order->getTotalItems();
+        totalRevenue += order->calculateTotalPrice();
+        if (order->getSoldAt() == 0) {
+            order->setSoldAt(chrono::duration_cast<chrono::seconds>(
+                    chrono::system_clock::now().time_since_epoch()).count());
+        }
+        {
+            SHOP_TRACE("shipOrder.analytics");
+            sales.record(*order);
+            timeline.record(*order);
+            sketches.record(*order);
+            for (const auto &orderItem: order->getItems()) {
+                modelNames.refresh(findItem(orderItem.getBike()->getModel())->getSku());
+            }
+            customers[order->getUser()].add(orders.size(), order->calculateTotalPrice());
+        }
+        // Після успішної відправки переміщуємо замовлення до історії
+        {
+            SHOP_TRACE("shipOrder.appendHistory");
+            orders.push_back(std::move(order));
+        }
+        cout << "Order shipped successfully!" << endl;
+    }
+
+    void renderOrders(ReportWriter &out) const {
+        if (orders.empty()) {
+            out << "No orders found." << '\n';
+        } else {
+            out << "Orders: " << '\n';
+            for (const auto &order: orders) {
+                order->render(out); // Виведення інформації для кожного замовлення
+            }
+        }
+        out.flush();
+    }
+
+    void displayOrders() const {
+        SHOP_MEASURE(DisplayOrders);
+        StreamSink sink(cout);
+        ReportWriter out(sink);
+        renderOrders(out);
+    }
+
+    // Сторінка інвентарю, починаючи з SKU cursor (0 - з початку)
+    // Інвентар упорядкований за SKU, тож початок сторінки знаходиться бінарним пошуком, навіть якщо
+    // частину позицій видалено. Без фільтра час пропорційний розміру сторінки; з фільтром - кількості
+    // переглянутих позицій. Вказівники дійсні до наступної зміни інвентарю
+    [[nodiscard]] Page<InventoryItem> pageInventory(uint64_t cursor, size_t pageSize,
+                                                    const function<bool(const InventoryItem &)> &filter = {}) const {
+        SHOP_MEASURE(PageInventory);
+        if (pageSize == 0) throw invalid_argument("Page size must be positive.");
+        Page<InventoryItem> page;
+        page.items.reserve(pageSize);
+        auto it = lower_bound(inventory.begin(), inventory.end(), cursor,
+                              [](const InventoryItem &item, uint64_t sku) { return item.getSku() < sku; });
+        for (; it != inventory.end(); ++it) {
+            if (filter && !filter(*it)) continue;
+            if (page.items.size() == pageSize) {
+                page.next = it->getSku();
+                break;
+            }
+            page.items.push_back(&*it);
+        }
+        return page;
+    }
+
+    // Сторінка історії замовлень, починаючи з порядкового номера cursor
+    // Історія лише доповнюється, тож курсор стабільний; замовлення не переміщуються в пам'яті
+    [[nodiscard]] Page<Order> pageOrders(uint64_t cursor, size_t pageSize,
+                                         const function<bool(const Order &)> &filter = {}) const {
+        SHOP_MEASURE(PageOrders);
+        if (pageSize == 0) throw invalid_argument("Page size must be positive.");
+        Page<Order> page;
+        page.items.reserve(pageSize);
+        for (size_t ordinal = cursor; ordinal < orders.size(); ++ordinal) {
+            if (filter && !filter(*orders[ordinal])) continue;
+            if (page.items.size() == pageSize) {
+                page.next = ordinal;
+                break;
+            }
+            page.items.push_back(orders[ordinal].get());
+        }
+        return page;
+    }
+
+    // Вивантаження інвентарю в CSV або JSON напряму зі стану магазину
+    void exportInventory(ReportSink &sink, ExportFormat format, unsigned threadCount = 0) const {
+        SHOP_MEASURE(ExportInventory);
+        ReportWriter header(sink);
+        if (format == ExportFormat::Csv) {
+            header << "sku,model,type,frame_size,wheel_size,gear_count,price,quantity,reserved,"
+                      "suspension_model,suspension_type,aerodynamics\n";
+        } else {
+            header << '[';
+        }
+        header.flush();
+        formatChunked(inventory.size(), sink, threadCount, [&](ReportWriter &out, size_t index) {
+            writeInventoryRecord(out, inventory[index], format, index);
+        });
+        if (format == ExportFormat::Json) sink.write("\n]\n");
+    }
+
+    // Вивантаження історії замовлень; у CSV - рядок на кожну позицію замовлення
+    // Результат не залежить від кількості потоків
+    void exportOrders(ReportSink &sink, ExportFormat format, unsigned threadCount = 0) const {
+        SHOP_MEASURE(ExportOrders);
+        ReportWriter header(sink);
+        if (format == ExportFormat::Csv) {
+            header << "order,sold_at,user,order_type,model,quantity,line_total,order_subtotal,order_total\n";
+        } else {
+            header << '[';
+        }
+        header.flush();
+        formatChunked(orders.size(), sink, threadCount, [&](ReportWriter &out, size_t index) {
+            writeOrderRecord(out, *orders[index], format, index);
+        });
+        if (format == ExportFormat::Json) sink.write("\n]\n");
+    }
+
+    void exportInventoryToFile(const string &file, ExportFormat format, unsigned threadCount = 0) const {
+        exportToFile(file, [&](ReportSink &sink) { exportInventory(sink, format, threadCount); });
+    }
+
+    void exportOrdersToFile(const string &file, ExportFormat format, unsigned threadCount = 0) const {
+        exportToFile(file, [&](ReportSink &sink) { exportOrders(sink, format, threadCount); });
+    }
+
+    void saveInventoryToFile(const string &file) {
+        SHOP_TRACE("save.inventory");
+        ofstream outFile(file);
+        if (!outFile) {
+            throw runtime_error("Failed to open file for writing.");
+        }
+        outFile << "V" << dataFormatVersion << endl;
+        outFile << inventory.size() << endl;
+        for (const auto &item: inventory) {
+            outFile << *item.getBike() << " "
+                    << item.getQuantity() << " ";
+        }
+        outFile << endl;
+        outFile.close();
+    }
+
+    void saveOrdersToFile(const string &file) {
+        SHOP_TRACE("save.orders");
+        ofstream outFile(file, ios::app);
+        if (!outFile) {
+            throw runtime_error("Failed to open file for writing.");
+        }
+        outFile << orders.size() << endl;
+        for (const auto &order: orders) {
+            outFile << *order << " ";
+        }
+        outFile << endl;
+        outFile.close();
+    }
+
+    void saveStaticsToFile(const string &file) {
+        SHOP_TRACE("save.statics");
+        ofstream outFile(file, ios::app);
+        if (!outFile) {
+            throw runtime_error("Failed to open file for writing.");
+        }
+        outFile << totalRevenue << endl << totalSoldItems << endl;
+
+        outFile.close();
+    }
+
+    void saveSketchesToFile(const string &file) {
+        SHOP_TRACE("save.sketches");
+        ofstream outFile(file, ios::app);
+        if (!outFile) {
+            throw runtime_error("Failed to open file for writing.");
+        }
+        sketches.write(outFile);
+        outFile.close();
+    }
+
+    void saveAllDataToFile(const string &file) {
+        SHOP_MEASURE(SaveAllDataToFile);
+        saveInventoryToFile(file);
+        saveStaticsToFile(file);
+        saveOrdersToFile(file);
+        saveSketchesToFile(file);
+        cout << "All data saved to file: " << file << endl;
+    }
+
+    Bike *loadBikeFromFile(istream &input) {
+        int type;
+        string model;
+        double frameSize, wheelSize, price;
+        int gearCount;
+        input >> type >> model >> frameSize >> wheelSize >> gearCount >> price;
+        Bike *bike;
+        //в залежності від типу зчитуємо різні поля
+        if (type == 0) {
+            string suspension;
+            int suspType;
+            input >> suspension >> suspType;
+            bike = new MountainBike(model, frameSize, wheelSize, gearCount, price, suspension,
+                                    static_cast<SuspensionType>(suspType));
+        } else {
+            int aerodynam;
+            input >> aerodynam;
+            bike = new RoadBike(model, frameSize, wheelSize, gearCount, price,
+                                static_cast<AerodynamicsLevel>(aerodynam));
+        }
+        return bike;
+    }
+
+    void loadFromfile(const string &file) {
+        SHOP_MEASURE(LoadFromFile);
+        ifstream input(file);
+        if (!input.is_open()) throw runtime_error("Couldn't open the file");
+
+        //Інвентар публікується читачам однією версією після завантаження
+        CatalogVersions::Batch publish(catalogVersions);
+        inventory.clear();
+        modelIndex.clear();
+        skuSlots.clear();
+        catalog.clear();
+        modelNames.clear();
+        lowStock.clear();
+        catalogVersions.clear();
+        size_t size;
+        //Версія формату (файли без заголовка мають версію 1) і розмір інвентаря
+        int version = 1;
+        string header;
+        input >> header;
+        if (!header.empty() && header[0] == 'V') {
+            version = stoi(header.substr(1));
+            if (version > dataFormatVersion) throw runtime_error("Unsupported data file version.");
+            input >> size;
+        } else {
+            size = stoul(header);
+        }
+        {
+            SHOP_TRACE("loadFromfile.inventory");
+            for (size_t i = 0; i < size; i++) {
+                shared_ptr<Bike> bike(loadBikeFromFile(input));
+                int quantity;
+                input >> quantity;
+                inventory.emplace_back(std::move(bike), quantity, &lowStock);
+                indexLastItem();
+            }
+            modelNames.compact();
+        }
+
+        //Статичні змінні
+        input >> totalRevenue >> totalSoldItems;
+
+
+        //Замовлення
+        //Кіл-сть замовлень
+        input >> size;
+        {
+            SHOP_TRACE("loadFromfile.orders");
+            orders.clear();
+            sales.clear();
+            timeline.clear();
+            sketches.clear();
+            for (size_t i = 0; i < size; ++i) {
+                unique_ptr<Order> order;
+                int type;
+                string user;
+                //Кіл-сть предметів у замовленні
+                size_t sizeItems;
+                long long soldAt = 0;
+                input >> type;
+                if (version >= 2) input >> soldAt;
+                input >> user >> sizeItems;
+                //Позиції переміщуються в замовлення; розмір з файлу обмежено, щоб пошкоджений файл не виділяв зайве
+                vector<OrderItem> items;
+                items.reserve(min<size_t>(sizeItems, 64));
+                for (size_t j = 0; j < sizeItems; ++j) {
+                    shared_ptr<Bike> bike(loadBikeFromFile(input));
+                    int quantity;
+                    input >> quantity;
+                    items.emplace_back(std::move(bike), quantity);
+                }
+                switch (type) {
+                    case 0:
+                        order = make_unique<Order>(user, std::move(items));
+                        break;
+                    case 1:
+                        float discount;
+                        input >> discount;
+                        order = make_unique<FixedDiscountOrder>(user, std::move(items), discount);
+                        break;
+                    case 2:
+                        order = make_unique<ProgressiveDiscountOrder>(user, std::move(items));
+                        break;
+                    default:
+                        throw runtime_error("Unknown order type in file.");
+                }
+                order->setSoldAt(soldAt);
+                sales.record(*order);
+                timeline.record(*order);
+                //Старі файли не містять скетчів - вони відновлюються з історії
+                if (version < 3) sketches.record(*order);
+                orders.push_back(std::move(order));
+            }
+        }
+        {
+            SHOP_TRACE("loadFromfile.sketches");
+            //Скетчі можуть охоплювати довшу історію, ніж збережені замовлення
+            if (version >= 3) sketches = StreamingSketches::read(input);
+        }
+        {
+            SHOP_TRACE("loadFromfile.indexes");
+            rebuildCustomerIndex();
+            modelNames.rescore();
+        }
+    }
+
+    // Утримання товару без зменшення запасу
+    void holdStock(const string &model, int quantity) {
+        SHOP_MEASURE(HoldStock);
+        InventoryItem *item = findItem(model);
+        if (!item) throw runtime_error("Bike with the specified model not found in inventory.");
+        item->reserve(quantity);
+        refreshStock(*item);
+    }
+
+    void releaseStock(const string &model, int quantity) {
+        SHOP_MEASURE(ReleaseStock);
+        if (InventoryItem *item = findItem(model)) {
+            item->release(quantity);
+            refreshStock(*item);
+        }
+    }
+
+    [[nodiscard]] int getAvailableQuantity(const string &model) {
+        SHOP_MEASURE(GetAvailableQuantity);
+        InventoryItem *item = findItem(model);
+        return item ? item->getAvailable() : 0;
+    }
+
+    // Пошук у каталозі за атрибутами; результат - множина SKU
+    [[nodiscard]] RoaringBitmap filterCatalog(const CatalogFilter &filter) const {
+        SHOP_MEASURE(FilterCatalog);
+        return catalog.query(filter);
+    }
+
+    [[nodiscard]] const CatalogIndex &getCatalogIndex() const {
+        return catalog;
+    }
+
+    // Велосипеди за множиною SKU у порядку інвентарю
+    [[nodiscard]] vector<Bike *> getBikes(const RoaringBitmap &skus) const {
+        vector<Bike *> result;
+        result.reserve(skus.cardinality());
+        skus.forEach([&](uint32_t sku) {
+            if (sku < skuSlots.size() && skuSlots[sku] != string::npos) {
+                result.push_back(inventory[skuSlots[sku]].getBike());
+            }
+        });
+        return result;
+    }
+
+    // Автодоповнення назви моделі: k підказок з найбільшим запасом або продажами
+    [[nodiscard]] vector<string> autocomplete(const string &prefix, size_t k,
+                                              CompletionRank rank = CompletionRank::Stock) const {
+        SHOP_MEASURE(Autocomplete);
+        return modelNames.complete(prefix, k, rank);
+    }
+
+    void setReorderPoint(const string &model, int point) {
+        SHOP_MEASURE(SetReorderPoint);
+        InventoryItem *item = findItem(model);
+        if (!item) throw runtime_error("Bike with the specified model not found in inventory.");
+        item->setReorderPoint(point);
+    }
+
+    // Моделі із запасом нижче порогу дозамовлення, від найбільшої нестачі
+    [[nodiscard]] vector<string> getLowStockModels() const {
+        return lowStock.models();
+    }
+
+    // Виклик при переході моделі нижче порогу
+    void setLowStockCallback(function<void(const string &model, int quantity, int reorderPoint)> callback) {
+        lowStock.setCallback(std::move(callback));
+    }
+
+    // Паралельний прохід історією замовлень
+    // map(acc, order[, ordinal]) додає замовлення до часткового результату потоку, reduce(into, from) зливає два;
+    // init має бути нейтральним елементом, бо копіюється у кожен потік
+    template<typename T, typename Map, typename Reduce>
+    T aggregateOrders(T init, Map map, Reduce reduce, unsigned threadCount = 0) const {
+        constexpr size_t minOrdersPerThread = 16384;
+        if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+        size_t useful = max<size_t>(1, orders.size() / minOrdersPerThread);
+        size_t threads = min<size_t>(threadCount, useful);
+
+        vector<T> partials(threads, init);
+        auto scan = [&](size_t part) {
+            size_t begin = orders.size() * part / threads;
+            size_t end = orders.size() * (part + 1) / threads;
+            for (size_t i = begin; i < end; ++i) {
+                if constexpr (is_invocable_v<Map &, T &, const Order &, size_t>) {
+                    map(partials[part], static_cast<const Order &>(*orders[i]), i);
+                } else {
+                    map(partials[part], static_cast<const Order &>(*orders[i]));
+                }
+            }
+        };
+
+        vector<exception_ptr> errors(threads);
+        vector<thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t part = 1; part < threads; ++part) {
+            workers.emplace_back([&, part] {
+                try {
+                    scan(part);
+                } catch (...) {
+                    errors[part] = current_exception();
+                }
+            });
+        }
+        try {
+            scan(0);
+        } catch (...) {
+            errors[0] = current_exception();
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        for (auto &error: errors) {
+            if (error) rethrow_exception(error);
+        }
+
+        // Злиття у порядку частин, щоб результат не залежав від планування потоків
+        for (size_t part = 1; part < threads; ++part) {
+            reduce(partials[0], partials[part]);
+        }
+        return std::move(partials[0]);
+    }
+
+    // Виручка і кількість замовлень за типами замовлень
+    [[nodiscard]] array<SalesBucket, 3> revenueByOrderType(unsigned threadCount = 0) const {
+        return aggregateOrders(
+                array<SalesBucket, 3>{},
+                [](array<SalesBucket, 3> &acc, const Order &order) {
+                    acc[static_cast<size_t>(order.getType())] += {order.getTotalItems(), order.calculateTotalPrice(), 1};
+                },
+                [](array<SalesBucket, 3> &into, const array<SalesBucket, 3> &from) {
+                    for (size_t i = 0; i < into.size(); ++i) into[i] += from[i];
+                },
+                threadCount);
+    }
+
+    // Середня знижка на замовлення у грошах
+    [[nodiscard]] double averageDiscount(unsigned threadCount = 0) const {
+        auto [discount, count] = aggregateOrders(
+                pair<double, size_t>{0, 0},
+                [](pair<double, size_t> &acc, const Order &order) {
+                    acc.first += order.getSubtotal() - order.calculateTotalPrice();
+                    ++acc.second;
+                },
+                [](pair<double, size_t> &into, const pair<double, size_t> &from) {
+                    into.first += from.first;
+                    into.second += from.second;
+                },
+                threadCount);
+        return count ? discount / static_cast<double>(count) : 0;
+    }
+
+    // Кількість придбаних велосипедів кожним покупцем
+    [[nodiscard]] unordered_map<string, long long> unitsPerCustomer(unsigned threadCount = 0) const {
+        return aggregateOrders(
+                unordered_map<string, long long>{},
+                [](unordered_map<string, long long> &acc, const Order &order) {
+                    acc[order.getUser()] += order.getTotalItems();
+                },
+                [](unordered_map<string, long long> &into, const unordered_map<string, long long> &from) {
+                    for (const auto &[user, units]: from) into[user] += units;
+                },
+                threadCount);
+    }
+
+    // Паралельна перебудова індексу покупців; частини зливаються по порядку, тож номери замовлень лишаються впорядкованими
+    void rebuildCustomerIndex(unsigned threadCount = 0) {
+        SHOP_MEASURE(RebuildCustomerIndex);
+        using Index = unordered_map<string, CustomerStats>;
+        customers = aggregateOrders(
+                Index{},
+                [](Index &acc, const Order &order, size_t ordinal) {
+                    acc[order.getUser()].add(ordinal, order.calculateTotalPrice());
+                },
+                [](Index &into, const Index &from) {
+                    for (const auto &[user, stats]: from) into[user].append(stats);
+                },
+                threadCount);
+    }
+
+    // Статистика покупця або nullptr, якщо він нічого не замовляв
+    [[nodiscard]] const CustomerStats *findCustomer(const string &user) const {
+        auto it = customers.find(user);
+        return it == customers.end() ? nullptr : &it->second;
+    }
+
+    // Замовлення покупця у порядку відправки: O(кількості його замовлень)
+    [[nodiscard]] vector<const Order *> getCustomerOrders(const string &user) const {
+        SHOP_MEASURE(GetCustomerOrders);
+        vector<const Order *> result;
+        if (const CustomerStats *stats = findCustomer(user)) {
+            result.reserve(stats->orders.size());
+            for (size_t ordinal: stats->orders) {
+                result.push_back(orders[ordinal].get());
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] const SalesAnalytics &getSalesAnalytics() const {
+        return sales;
+    }
+
+    [[nodiscard]] const SalesTimeline &getSalesTimeline() const {
+        return timeline;
+    }
+
+    [[nodiscard]] const StreamingSketches &getSketches() const {
+        return sketches;
+    }
+
+    // Приєднання скетчів іншого шарда магазину
+    void mergeSketches(const StreamingSketches &other) {
+        sketches.merge(other);
+    }
+
+    [[nodiscard]] double estimateDistinctCustomers() const {
+        return sketches.distinctCustomers();
+    }
+
+    [[nodiscard]] double estimateDistinctCustomers(const string &model) const {
+        return sketches.distinctCustomers(model);
+    }
+
+    [[nodiscard]] vector<pair<string, uint64_t>> getHeavyHitters(size_t n) const {
+        return sketches.heavyHitters(n);
+    }
+
+    // Пам'ять магазину за фактичними місткостями контейнерів; час пропорційний кількості позицій замовлень
+    [[nodiscard]] MemoryUsage memoryUsage() const {
+        MemoryUsage usage;
+        auto addBike = [&usage](const Bike &bike) {
+            if (auto mountain = dynamic_cast<const MountainBike *>(&bike)) {
+                usage.bikes += sizeof(MountainBike);
+                usage.strings += heapBytes(mountain->getSuspensionModel());
+            } else {
+                usage.bikes += sizeof(RoadBike);
+            }
+            usage.strings += heapBytes(bike.getModel());
+        };
+
+        usage.inventory = heapBytes(inventory);
+        for (const auto &item: inventory) addBike(*item.getBike());
+
+        usage.orders = heapBytes(orders);
+        unordered_set<const Bike *> retired;
+        for (const auto &order: orders) {
+            switch (order->getType()) {
+                case OrderType::FixedDiscount:
+                    usage.orders += sizeof(FixedDiscountOrder);
+                    break;
+                case OrderType::ProgressiveDiscount:
+                    usage.orders += sizeof(ProgressiveDiscountOrder);
+                    break;
+                default:
+                    usage.orders += sizeof(Order);
+            }
+            usage.orderLines += order->itemsMemoryBytes();
+            usage.strings += heapBytes(order->getUser());
+            // Відправлені замовлення посилаються на велосипеди інвентаря, завантажені - мають власні копії;
+            // велосипед, видалений з інвентаря, може спільно утримуватись кількома рядками
+            for (const auto &orderItem: order->getItems()) {
+                auto it = modelIndex.find(orderItem.getBike()->getModel());
+                if (it != modelIndex.end() && inventory[it->second].getBike() == orderItem.getBike()) continue;
+                if (orderItem.getBikeOwners() == 1 || retired.insert(orderItem.getBike()).second) {
+                    addBike(*orderItem.getBike());
+                }
+            }
+        }
+
+        usage.indexes = tableBytes(modelIndex) + heapBytes(skuSlots) + catalog.memoryBytes() +
+                        modelNames.memoryBytes() + lowStock.memoryBytes() + tableBytes(customers);
+        for (const auto &[model, position]: modelIndex) usage.indexes += heapBytes(model);
+        for (const auto &[user, stats]: customers) usage.indexes += heapBytes(user) + heapBytes(stats.orders);
+
+        usage.analytics = sales.memoryBytes() + timeline.memoryBytes() + sketches.memoryBytes();
+        usage.snapshots = catalogVersions.memoryBytes();
+        return usage;
+    }
+
+    [[nodiscard]] static int getTotalSoldItems() { return totalSoldItems; }
+
+    [[nodiscard]] static double getTotalRevenue() { return totalRevenue; }
+
+    [[nodiscard]] size_t getInventorySize() const { return inventory.size(); }
+
+    [[nodiscard]] size_t getOrderCount() const { return orders.size(); }
+
+    static void displayStatics() {
+        cout << "Total sold: " << totalSoldItems << endl << "Total revenue: " << totalRevenue << endl
+             << "-----------------------------" << endl;
+    }
+};
+
+
+inline int Shop::totalSoldItems = 0;
+inline double Shop::totalRevenue = 0;
+
+// Політика поведінки при переповненій черзі замовлень
+enum class BackpressurePolicy {
+    Block,  // Чекати, доки звільниться місце
+    Reject, // Одразу відхилити нове замовлення
+    Shed    // Викинути найстаріше замовлення з черги
+};
+
+// Результат обробки замовлення з черги
+enum class IntakeStatus {
+    Shipped,
+    Rejected,
+    Shed,
+    Failed
+};
+
+struct IntakeResult {
+    IntakeStatus status;
+    string error;
+};
+
+// Обмежена lock-free черга для багатьох виробників і споживачів (алгоритм Вьюкова)
+template<typename T>
+class BoundedMPMCQueue {
+    struct Cell {
+        atomic<size_t> sequence;
+        T data;
+    };
+
+    static constexpr size_t cacheLine = 64;
+
+    unique_ptr<Cell[]> buffer;
+    size_t mask;
+    alignas(cacheLine) atomic<size_t> enqueuePos{0};
+    alignas(cacheLine) atomic<size_t> dequeuePos{0};
+
+public:
+    // Ємність округлюється вгору до степеня двійки
+    explicit BoundedMPMCQueue(size_t capacity) {
+        if (capacity == 0) throw invalid_argument("Queue capacity must be positive.");
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        buffer = make_unique<Cell[]>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    BoundedMPMCQueue(const BoundedMPMCQueue &) = delete;
+
+    BoundedMPMCQueue &operator=(const BoundedMPMCQueue &) = delete;
+
+    // Значення переміщується у чергу лише у разі успіху
+    bool tryPush(T &value) {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &buffer[pos & mask];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Черга заповнена
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T &value) {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &buffer[pos & mask];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Черга порожня
+            } else {
+                pos = dequeuePos.load(memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->sequence.store(pos + mask + 1, memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+    // Приблизна кількість елементів (точна лише без конкурентних операцій)
+    [[nodiscard]] size_t sizeApprox() const {
+        size_t tail = enqueuePos.load(memory_order_relaxed);
+        size_t head = dequeuePos.load(memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+};
+
+// Прийом замовлень з будь-яких потоків і їх відправка пулом обробників
+// Пул відокремлює виробників від відправки, але не додає їй пропускної здатності: shipOrder змінює магазин
+// і виконується по одному під shop.operationMutex(). Паралельно йде лише попередня перевірка на знімку каталогу
+class OrderIntake {
+    struct Job {
+        unique_ptr<Order> order;
+        promise<IntakeResult> result;
+        function<void(const IntakeResult &)> callback;
+    };
+
+    Shop &shop; // Не потокобезпечний: відправка серіалізується через shop.operationMutex()
+    BoundedMPMCQueue<Job> queue;
+    atomic<size_t> callbackFailures{0};
+    counting_semaphore<> freeSlots; // Вільні місця черги: заблоковані виробники чекають без витрати процесора
+    counting_semaphore<> ready{0};  // Кількість замовлень, готових до обробки
+    BackpressurePolicy policy;
+    atomic<bool> stopping{false};
+    vector<thread> workers;
+
+    // Виняток з колбека не виходить за межі обробника (інакше terminate), а лише зараховується
+    void complete(Job &job, const IntakeResult &result) {
+        job.order.reset();
+        if (job.callback) {
+            try {
+                job.callback(result);
+            } catch (...) {
+                callbackFailures.fetch_add(1, memory_order_relaxed);
+            }
+        } else {
+            job.result.set_value(result);
+        }
+    }
+
+    // Попередня перевірка на знімку каталогу без замка: замовлення, яке точно не відправиться,
+    // не чекає на замок; остаточну перевірку робить shipOrder
+    bool available(const Order &order) const {
+        CatalogSnapshot catalog = shop.catalogSnapshot();
+        for (const auto &item: order.getItems()) {
+            const CatalogRecord *record = catalog.find(item.getBike()->getModel());
+            if (!record || record->getAvailable() < item.getQuantity()) return false;
+        }
+        return true;
+    }
+
+    void process(Job &job) {
+        IntakeResult result{IntakeStatus::Shipped, ""};
+        try {
+            if (!available(*job.order)) throw runtime_error("Not enough bikes in inventory to fulfill the order.");
+            lock_guard<mutex> lock(shop.operationMutex());
+            shop.shipOrder(std::move(job.order));
+        } catch (const exception &e) {
+            result = {IntakeStatus::Failed, e.what()};
+        }
+        complete(job, result);
+    }
+
+    // Сигнал ready означає, що замовлення вже у черзі або пул зупиняється; невдала спроба можлива
+    // лише на мить, поки інший виробник дописує свою комірку
+    bool popReady(Job &job) {
+        while (!queue.tryPop(job)) {
+            if (stopping.load(memory_order_acquire)) return false;
+            this_thread::yield();
+        }
+        return true;
+    }
+
+    void workerLoop() {
+        while (true) {
+            ready.acquire();
+            Job job;
+            if (!popReady(job)) return;
+            freeSlots.release();
+            process(job);
+        }
+    }
+
+    // Резервування місця в черзі за політикою; false, якщо замовлення відхилене
+    bool reserveSlot(Job &job) {
+        if (freeSlots.try_acquire()) return true;
+        switch (policy) {
+            case BackpressurePolicy::Block:
+                freeSlots.acquire();
+                return true;
+            case BackpressurePolicy::Reject:
+                complete(job, {IntakeStatus::Rejected, "Order intake queue is full."});
+                return false;
+            case BackpressurePolicy::Shed:
+                // Місце найстарішого замовлення переходить новому
+                if (ready.try_acquire()) {
+                    Job victim;
+                    popReady(victim);
+                    complete(victim, {IntakeStatus::Shed, "Order was shed due to intake overload."});
+                    return true;
+                }
+                // Усі замовлення вже в обробників - місце звільниться, щойно хтось забере наступне
+                freeSlots.acquire();
+                return true;
+        }
+        return false;
+    }
+
+    void enqueue(Job &job) {
+        if (!reserveSlot(job)) return;
+        // Місце зарезервоване; невдача можлива лише на мить, поки обробник дочитує комірку
+        while (!queue.tryPush(job)) this_thread::yield();
+        ready.release();
+    }
+
+public:
+    OrderIntake(Shop &shop, size_t capacity = 1024, unsigned workerCount = thread::hardware_concurrency(),
+                BackpressurePolicy policy = BackpressurePolicy::Block)
+            : shop(shop), queue(capacity), freeSlots(static_cast<ptrdiff_t>(queue.capacity())), policy(policy) {
+        if (workerCount == 0) workerCount = 1;
+        workers.reserve(workerCount);
+        for (unsigned i = 0; i < workerCount; ++i) {
+            workers.emplace_back(&OrderIntake::workerLoop, this);
+        }
+    }
+
+    OrderIntake(const OrderIntake &) = delete;
+
+    OrderIntake &operator=(const OrderIntake &) = delete;
+
+    // Обробляє всі прийняті замовлення і зупиняє обробників
+    ~OrderIntake() {
+        stopping.store(true, memory_order_release);
+        ready.release(static_cast<ptrdiff_t>(workers.size()));
+        for (auto &worker: workers) {
+            worker.join();
+        }
+    }
+
+    future<IntakeResult> submit(unique_ptr<Order> order) {
+        if (!order) throw invalid_argument("Order must not be null.");
+        Job job;
+        job.order = std::move(order);
+        auto result = job.result.get_future();
+        enqueue(job);
+        return result;
+    }
+
+    void submit(unique_ptr<Order> order, function<void(const IntakeResult &)> callback) {
+        if (!order) throw invalid_argument("Order must not be null.");
+        if (!callback) throw invalid_argument("Callback must not be empty.");
+        Job job;
+        job.order = std::move(order);
+        job.callback = std::move(callback);
+        enqueue(job);
+    }
+
+    // Виконання дії над магазином під тим самим замком, що й відправка
+    template<typename F>
+    auto withShop(F action) {
+        lock_guard<mutex> lock(shop.operationMutex());
+        return action(shop);
+    }
+
+    [[nodiscard]] size_t pending() const { return queue.sizeApprox(); }
+
+    [[nodiscard]] size_t capacity() const { return queue.capacity(); }
+
+    [[nodiscard]] size_t workerCount() const { return workers.size(); }
+
+    // Кількість колбеків, що завершились винятком
+    [[nodiscard]] size_t failedCallbacks() const { return callbackFailures.load(memory_order_relaxed); }
+};
+
+// Утримання товару для кошиків покупців з автоматичним закінченням терміну
+// Терміни відстежуються хешованим колесом таймерів: кожна операція O(1)
+class StockReservations {
+public:
+    using Clock = chrono::steady_clock;
+    using HoldId = unsigned long long;
+
+private:
+    struct Hold {
+        string user;
+        vector<pair<string, int>> lines; // Модель і утримувана кількість
+        size_t slot;                     // Слот колеса таймерів
+        size_t rounds;                   // Кількість повних обертів колеса до закінчення
+        list<HoldId>::iterator position; // Позиція у списку слоту
+    };
+
+    Shop &shop;
+    Clock::duration tick;
+    vector<list<HoldId>> wheel;
+    size_t current = 0;
+    Clock::time_point lastTick;
+    unordered_map<HoldId, Hold> holds;
+    HoldId nextId = 1;
+    function<void(HoldId, const Hold &)> onExpire;
+
+    // Слот відраховується від lastTick, а не від поточного моменту: колесо могло відстати від годинника,
+    // і наступний expire(now) спершу прокрутить пропущені такти
+    void schedule(HoldId id, Hold &hold, Clock::duration ttl, Clock::time_point now) {
+        auto delay = max(now - lastTick, Clock::duration::zero()) + ttl;
+        auto ticks = static_cast<size_t>((delay + tick - Clock::duration(1)) / tick);
+        if (ticks == 0) ticks = 1;
+        hold.slot = (current + ticks) % wheel.size();
+        hold.rounds = (ticks - 1) / wheel.size();
+        hold.position = wheel[hold.slot].insert(wheel[hold.slot].end(), id);
+    }
+
+    void releaseLines(const Hold &hold) {
+        for (const auto &[model, quantity]: hold.lines) {
+            shop.releaseStock(model, quantity);
+        }
+    }
+
+    void expireSlot() {
+        auto &bucket = wheel[current];
+        for (auto it = bucket.begin(); it != bucket.end();) {
+            auto holdIt = holds.find(*it);
+            Hold &hold = holdIt->second;
+            if (hold.rounds > 0) {
+                --hold.rounds;
+                ++it;
+                continue;
+            }
+            it = bucket.erase(it);
+            releaseLines(hold);
+            if (onExpire) onExpire(holdIt->first, hold);
+            holds.erase(holdIt);
+        }
+    }
+
+public:
+    explicit StockReservations(Shop &shop, Clock::duration tick = chrono::seconds(1), size_t wheelSize = 1024,
+                               Clock::time_point now = Clock::now())
+            : shop(shop), tick(tick), wheel(wheelSize), lastTick(now) {
+        if (tick <= Clock::duration::zero()) throw invalid_argument("Tick must be positive.");
+        if (wheelSize == 0) throw invalid_argument("Wheel size must be positive.");
+    }
+
+    StockReservations(const StockReservations &) = delete;
+
+    StockReservations &operator=(const StockReservations &) = delete;
+
+    // Утримання всіх позицій кошика; або всі утримуються, або жодна
+    HoldId reserve(const string &user, const vector<pair<string, int>> &lines, Clock::duration ttl,
+                   Clock::time_point now = Clock::now()) {
+        if (user.empty()) throw invalid_argument("User name cannot be empty.");
+        if (lines.empty()) throw invalid_argument("Reservation must contain at least one item.");
+        if (ttl <= Clock::duration::zero()) throw invalid_argument("Reservation ttl must be positive.");
+        size_t held = 0;
+        try {
+            for (; held < lines.size(); ++held) {
+                shop.holdStock(lines[held].first, lines[held].second);
+            }
+        } catch (...) {
+            for (size_t i = 0; i < held; ++i) {
+                shop.releaseStock(lines[i].first, lines[i].second);
+            }
+            throw;
+        }
+        HoldId id = nextId++;
+        Hold &hold = holds[id];
+        hold.user = user;
+        hold.lines = lines;
+        schedule(id, hold, ttl, now);
+        return id;
+    }
+
+    HoldId reserve(const string &user, const string &model, int quantity, Clock::duration ttl,
+                   Clock::time_point now = Clock::now()) {
+        return reserve(user, {{model, quantity}}, ttl, now);
+    }
+
+    // Перетворення утримання на відправлене замовлення
+    void confirm(HoldId id) {
+        auto it = holds.find(id);
+        if (it == holds.end()) throw runtime_error("Reservation not found or already expired.");
+        Hold &hold = it->second;
+
+        vector<OrderItem> items;
+        items.reserve(hold.lines.size());
+        for (const auto &[model, quantity]: hold.lines) {
+            Bike *bike = shop.findBikeByModel(model);
+            if (!bike) throw runtime_error("Reserved bike is no longer in inventory.");
+            items.emplace_back(bike, quantity);
+        }
+        auto order = make_unique<Order>(hold.user, std::move(items));
+
+        // Звільняємо утримання, щоб відправка побачила цей товар як доступний
+        releaseLines(hold);
+        try {
+            shop.shipOrder(std::move(order));
+        } catch (...) {
+            for (const auto &[model, quantity]: hold.lines) {
+                shop.holdStock(model, quantity);
+            }
+            throw;
+        }
+        wheel[hold.slot].erase(hold.position);
+        holds.erase(it);
+    }
+
+    // Скасування утримання покупцем
+    bool release(HoldId id) {
+        auto it = holds.find(id);
+        if (it == holds.end()) return false;
+        releaseLines(it->second);
+        wheel[it->second.slot].erase(it->second.position);
+        holds.erase(it);
+        return true;
+    }
+
+    // Прокрутка колеса до поточного моменту; повертає кількість прострочених утримань
+    size_t expire(Clock::time_point now = Clock::now()) {
+        size_t before = holds.size();
+        while (now - lastTick >= tick) {
+            lastTick += tick;
+            current = (current + 1) % wheel.size();
+            expireSlot();
+        }
+        return before - holds.size();
+    }
+
+    void setExpiryCallback(function<void(HoldId, const string &user)> callback) {
+        if (!callback) {
+            onExpire = nullptr;
+            return;
+        }
+        onExpire = [callback = std::move(callback)](HoldId id, const Hold &hold) { callback(id, hold.user); };
+    }
+
+    [[nodiscard]] bool isActive(HoldId id) const { return holds.count(id) != 0; }
+
+    [[nodiscard]] size_t activeCount() const { return holds.size(); }
+};
+
+// Корутина конвеєра замовлень: стартує одразу, кадр звільняється після завершення
+struct PipelineTask {
+    struct promise_type {
+        PipelineTask get_return_object() { return {}; }
+
+        suspend_never initial_suspend() noexcept { return {}; }
+
+        suspend_never final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+
+        void unhandled_exception() { terminate(); }
+    };
+};
+
+// Поетапна обробка замовлень: перевірка -> утримання товару -> ціна -> журнал -> публікація -> знімок
+// Поки замовлення чекає fsync журналу чи запису знімка, обробник виконує етапи інших замовлень
+// Перевірка (на знімку каталогу), ціна і журнал ідуть паралельно; утримання, відправка і збереження
+// знімка змінюють або читають сам магазин і тому виконуються по одному під shop.operationMutex()
+class OrderPipeline {
+    struct Worker {
+        mutex lock;
+        condition_variable wake;
+        deque<coroutine_handle<>> ready;
+        thread runner;
+    };
+
+    struct JournalRequest;
+
+    struct SnapshotRequest;
+
+    Shop &shop; // Не потокобезпечний: доступ серіалізується через shop.operationMutex()
+    vector<unique_ptr<Worker>> workers;
+    atomic<size_t> nextWorker{0};
+    atomic<bool> stopping{false};
+
+    FILE *journal;
+    mutex journalLock;
+    condition_variable journalWake;
+    vector<JournalRequest *> journalQueue;
+    bool journalStopping = false;
+    thread journalWriter;
+
+    string snapshotFile;     // Порожній - знімки не пишуться
+    size_t snapshotEvery;    // Знімок після кожних snapshotEvery відправлених замовлень
+    atomic<size_t> shipped{0};
+    mutex snapshotLock;
+    condition_variable snapshotWake;
+    vector<SnapshotRequest *> snapshotQueue;
+    bool snapshotStopping = false;
+    thread snapshotWriter;
+
+    mutex flightLock;
+    condition_variable flightDone;
+    size_t inFlight = 0;
+
+    // Перехід корутини на потік обробника
+    struct ScheduleOn {
+        OrderPipeline &pipeline;
+        size_t worker;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(coroutine_handle<> handle) { pipeline.post(worker, handle); }
+
+        void await_resume() const noexcept {}
+    };
+
+    // Запис у журнал: корутина призупиняється до завершення fsync
+    struct JournalRequest {
+        OrderPipeline &pipeline;
+        size_t worker;
+        string line;
+        coroutine_handle<> handle;
+        bool failed = false;
+
+        JournalRequest(OrderPipeline &pipeline, size_t worker, string line)
+                : pipeline(pipeline), worker(worker), line(std::move(line)) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        // Після публікації запит може бути вже виконаний, а кадр корутини звільнений - this більше не чіпаємо
+        void await_suspend(coroutine_handle<> h) {
+            handle = h;
+            OrderPipeline &owner = pipeline;
+            {
+                lock_guard<mutex> lock(owner.journalLock);
+                owner.journalQueue.push_back(this);
+            }
+            owner.journalWake.notify_one();
+        }
+
+        void await_resume() const {
+            if (failed) throw runtime_error("Failed to write order journal.");
+        }
+    };
+
+    // Запис знімка магазину: корутина призупиняється, доки фоновий потік не збереже файл
+    // Повідомлення про помилку повертається з co_await; порожнє - знімок записано
+    struct SnapshotRequest {
+        OrderPipeline &pipeline;
+        size_t worker;
+        coroutine_handle<> handle;
+        string error;
+
+        SnapshotRequest(OrderPipeline &pipeline, size_t worker) : pipeline(pipeline), worker(worker) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        // Як і в JournalRequest, після публікації this не використовується
+        void await_suspend(coroutine_handle<> h) {
+            handle = h;
+            OrderPipeline &owner = pipeline;
+            {
+                lock_guard<mutex> lock(owner.snapshotLock);
+                owner.snapshotQueue.push_back(this);
+            }
+            owner.snapshotWake.notify_one();
+        }
+
+        string await_resume() { return std::move(error); }
+    };
+
+    void post(size_t worker, coroutine_handle<> handle) {
+        Worker &w = *workers[worker];
+        {
+            lock_guard<mutex> lock(w.lock);
+            w.ready.push_back(handle);
+        }
+        w.wake.notify_one();
+    }
+
+    void workerLoop(Worker &w) {
+        while (true) {
+            coroutine_handle<> handle;
+            {
+                unique_lock<mutex> lock(w.lock);
+                w.wake.wait(lock, [&] { return stopping || !w.ready.empty(); });
+                if (w.ready.empty()) return;
+                handle = w.ready.front();
+                w.ready.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    static bool syncToDisk(FILE *file) {
+        if (fflush(file) != 0) return false;
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+
+    // Групове збереження: один fsync на всі записи, що накопичились
+    void journalLoop() {
+        vector<JournalRequest *> batch;
+        while (true) {
+            {
+                unique_lock<mutex> lock(journalLock);
+                journalWake.wait(lock, [&] { return journalStopping || !journalQueue.empty(); });
+                if (journalQueue.empty()) return;
+                batch.swap(journalQueue);
+            }
+            bool ok = true;
+            for (auto request: batch) {
+                ok = ok && fputs(request->line.c_str(), journal) >= 0 && fputc('\n', journal) != EOF;
+            }
+            ok = ok && syncToDisk(journal);
+            for (auto request: batch) {
+                request->failed = !ok;
+                post(request->worker, request->handle);
+            }
+            batch.clear();
+        }
+    }
+
+    // Один знімок на всі запити, що накопичились: усі вони бачать стан не старіший за свій
+    // Файл пишеться поруч і перейменовується, тож попередній знімок лишається цілим при збої
+    void snapshotLoop() {
+        vector<SnapshotRequest *> batch;
+        while (true) {
+            {
+                unique_lock<mutex> lock(snapshotLock);
+                snapshotWake.wait(lock, [&] { return snapshotStopping || !snapshotQueue.empty(); });
+                if (snapshotQueue.empty()) return;
+                batch.swap(snapshotQueue);
+            }
+            string error;
+            try {
+                string temporary = snapshotFile + ".tmp";
+                {
+                    lock_guard<mutex> lock(shop.operationMutex());
+                    shop.saveAllDataToFile(temporary);
+                }
+                // На Windows rename не замінює наявний файл
+                if (rename(temporary.c_str(), snapshotFile.c_str()) != 0 &&
+                    (remove(snapshotFile.c_str()), rename(temporary.c_str(), snapshotFile.c_str()) != 0)) {
+                    throw runtime_error("Failed to replace snapshot file.");
+                }
+            } catch (const exception &e) {
+                error = e.what();
+            }
+            for (auto request: batch) {
+                request->error = error;
+                post(request->worker, request->handle);
+            }
+            batch.clear();
+        }
+    }
+
+    // Перевірка читає опубліковану версію каталогу без замка магазину
+    bool validate(const Order &order) {
+        if (order.getItems().empty()) return false;
+        CatalogSnapshot catalog = shop.catalogSnapshot();
+        for (const auto &item: order.getItems()) {
+            if (!catalog.find(item.getBike()->getModel())) return false;
+        }
+        return true;
+    }
+
+    void reserve(const Order &order) {
+        lock_guard<mutex> lock(shop.operationMutex());
+        auto items = order.getItems();
+        size_t held = 0;
+        try {
+            for (; held < items.size(); ++held) {
+                shop.holdStock(items[held].getBike()->getModel(), items[held].getQuantity());
+            }
+        } catch (...) {
+            for (size_t i = 0; i < held; ++i) {
+                shop.releaseStock(items[i].getBike()->getModel(), items[i].getQuantity());
+            }
+            throw;
+        }
+    }
+
+    void releaseHolds(const Order &order) {
+        for (const auto &item: order.getItems()) {
+            shop.releaseStock(item.getBike()->getModel(), item.getQuantity());
+        }
+    }
+
+    void finish(promise<IntakeResult> &result, const IntakeResult &outcome) {
+        result.set_value(outcome);
+        lock_guard<mutex> lock(flightLock);
+        if (--inFlight == 0) flightDone.notify_all();
+    }
+
+    PipelineTask process(size_t worker, unique_ptr<Order> order, promise<IntakeResult> result) {
+        co_await ScheduleOn{*this, worker};
+
+        if (!validate(*order)) {
+            finish(result, {IntakeStatus::Failed, "Order is empty or refers to bikes missing from inventory."});
+            co_return;
+        }
+
+        try {
+            reserve(*order);
+        } catch (const exception &e) {
+            finish(result, {IntakeStatus::Failed, e.what()});
+            co_return;
+        }
+
+        IntakeResult outcome{IntakeStatus::Shipped, ""};
+        try {
+            // Ціна фіксується до журналу, щоб запис містив остаточну суму
+            double total = order->calculateTotalPrice();
+            JournalRequest entry(*this, worker, order->toString() + " " + to_string(total));
+            co_await entry;
+
+            lock_guard<mutex> lock(shop.operationMutex());
+            releaseHolds(*order);
+            shop.shipOrder(std::move(order));
+        } catch (const exception &e) {
+            if (order) {
+                lock_guard<mutex> lock(shop.operationMutex());
+                releaseHolds(*order);
+            }
+            outcome = {IntakeStatus::Failed, e.what()};
+        }
+
+        // Відправлене замовлення лишається відправленим; помилка знімка лише повідомляється
+        if (outcome.status == IntakeStatus::Shipped && !snapshotFile.empty() &&
+            shipped.fetch_add(1, memory_order_relaxed) % snapshotEvery == snapshotEvery - 1) {
+            string error = co_await SnapshotRequest(*this, worker);
+            if (!error.empty()) outcome.error = "Snapshot write failed: " + error;
+        }
+        finish(result, outcome);
+    }
+
+public:
+    // З snapshotFile магазин зберігається у файл після кожних snapshotEvery відправлених замовлень
+    OrderPipeline(Shop &shop, const string &journalFile, unsigned workerCount = thread::hardware_concurrency(),
+                  const string &snapshotFile = "", size_t snapshotEvery = 1000)
+            : shop(shop), snapshotFile(snapshotFile), snapshotEvery(snapshotEvery) {
+        if (snapshotEvery == 0) throw invalid_argument("Snapshot interval must be positive.");
+        journal = fopen(journalFile.c_str(), "a");
+        if (!journal) throw runtime_error("Failed to open journal file.");
+        if (workerCount == 0) workerCount = 1;
+        for (unsigned i = 0; i < workerCount; ++i) {
+            workers.push_back(make_unique<Worker>());
+        }
+        for (auto &w: workers) {
+            w->runner = thread(&OrderPipeline::workerLoop, this, ref(*w));
+        }
+        journalWriter = thread(&OrderPipeline::journalLoop, this);
+        snapshotWriter = thread(&OrderPipeline::snapshotLoop, this);
+    }
+
+    OrderPipeline(const OrderPipeline &) = delete;
+
+    OrderPipeline &operator=(const OrderPipeline &) = delete;
+
+    // Дочікується завершення всіх замовлень у роботі
+    ~OrderPipeline() {
+        {
+            unique_lock<mutex> lock(flightLock);
+            flightDone.wait(lock, [&] { return inFlight == 0; });
+        }
+        {
+            lock_guard<mutex> lock(journalLock);
+            journalStopping = true;
+        }
+        journalWake.notify_one();
+        journalWriter.join();
+        {
+            lock_guard<mutex> lock(snapshotLock);
+            snapshotStopping = true;
+        }
+        snapshotWake.notify_one();
+        snapshotWriter.join();
+        stopping = true;
+        for (auto &w: workers) {
+            {
+                lock_guard<mutex> lock(w->lock);
+            }
+            w->wake.notify_one();
+            w->runner.join();
+        }
+        fclose(journal);
+    }
+
+    future<IntakeResult> submit(unique_ptr<Order> order) {
+        if (!order) throw invalid_argument("Order must not be null.");
+        promise<IntakeResult> result;
+        auto outcome = result.get_future();
+        {
+            lock_guard<mutex> lock(flightLock);
+            ++inFlight;
+        }
+        size_t worker = nextWorker.fetch_add(1, memory_order_relaxed) % workers.size();
+        process(worker, std::move(order), std::move(result));
+        return outcome;
+    }
+
+    // Виконання дії над магазином під тим самим замком, що й етапи конвеєра
+    template<typename F>
+    auto withShop(F action) {
+        lock_guard<mutex> lock(shop.operationMutex());
+        return action(shop);
+    }
+
+    [[nodiscard]] size_t workerCount() const { return workers.size(); }
+};
+
+#endif //INDIV_OOP_SHOP_H
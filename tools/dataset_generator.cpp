@@ -0,0 +1,287 @@
+#include "shop.h"
+
+#include <random>
+
+// Генератор синтетичних даних магазину
+// Запуск: Indiv_OOP_datagen --out=data.txt [--bikes=10000] [--orders=100000] [--customers=20000]
+//         [--zipf=1.1] [--format=3] [--seed=1] [--start=1700000000]
+//         [--trace=trace.txt] [--trace-ops=100000]
+// Файл даних має той самий текстовий формат, що й saveAllDataToFile (версії 1-3), тож його можна
+// завантажити через loadFromfile. Популярність моделей і покупців розподілена за Ципфом.
+// Траса - послідовність операцій над тим самим магазином для відтворення у бенчмарку (--trace у Indiv_OOP_bench)
+
+struct GeneratorConfig {
+    string out;
+    size_t bikes = 10000;
+    size_t orders = 100000;
+    size_t customers = 20000;
+    double zipf = 1.1;
+    int format = 3;
+    uint64_t seed = 1;
+    long long start = 1700000000;
+    string trace;
+    size_t traceOps = 100000;
+};
+
+// Вибір рангу 0..n-1 з імовірністю, пропорційною 1 / (ранг + 1)^s
+// Ранги переставлені випадково, тож популярні номери не збігаються з першими в інвентарі
+class ZipfSampler {
+    vector<double> cumulative;
+    vector<uint32_t> permutation;
+
+public:
+    ZipfSampler(size_t n, double exponent, mt19937_64 &rng) : cumulative(n), permutation(n) {
+        if (n == 0) throw invalid_argument("Zipf sampler needs at least one element.");
+        double sum = 0;
+        for (size_t rank = 0; rank < n; ++rank) {
+            sum += 1.0 / pow(static_cast<double>(rank + 1), exponent);
+            cumulative[rank] = sum;
+        }
+        for (auto &value: cumulative) value /= sum;
+        for (size_t i = 0; i < n; ++i) permutation[i] = static_cast<uint32_t>(i);
+        shuffle(permutation.begin(), permutation.end(), rng);
+    }
+
+    size_t operator()(mt19937_64 &rng) const {
+        double u = uniform_real_distribution<double>(0, 1)(rng);
+        size_t rank = lower_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin();
+        return permutation[min(rank, cumulative.size() - 1)];
+    }
+};
+
+class DatasetGenerator {
+    const GeneratorConfig &config;
+    mt19937_64 rng;
+    vector<shared_ptr<Bike>> bikes;
+    vector<long long> stock;
+    ZipfSampler bikePopularity;
+    ZipfSampler customerPopularity;
+    long long clock;
+
+    static constexpr const char *suspensions[] = {"Fox", "RockShox", "SR-Suntour", "Manitou", "DVO"};
+
+    // Назва моделі - префікс типу і suffix (для початкового інвентарю - номер моделі)
+    unique_ptr<Bike> makeBike(const string &suffix) {
+        double frame = 14 + static_cast<double>(rng() % 10);
+        double price = 400 + static_cast<double>(rng() % 760000) / 100;
+        int gears = 1 + static_cast<int>(rng() % 24);
+        if (rng() % 2) {
+            return make_unique<MountainBike>("MTB-" + suffix, frame, rng() % 2 ? 27.5 : 29, gears, price,
+                                             suspensions[rng() % size(suspensions)],
+                                             rng() % 3 ? SuspensionType::Hardtail : SuspensionType::Full);
+        }
+        return make_unique<RoadBike>("Road-" + suffix, frame + 36, 28, gears, price,
+                                     static_cast<AerodynamicsLevel>(1 + rng() % 3));
+    }
+
+    // Номер моделі початкового інвентарю за її назвою
+    static size_t indexOf(const Bike &bike) {
+        const string &model = bike.getModel();
+        return stoul(model.substr(model.find('-') + 1));
+    }
+
+    static void writeBike(ReportWriter &out, const Bike &bike) {
+        out << static_cast<int>(bike.getType()) << ' ' << bike.getModel() << ' ' << bike.getFrameSize() << ' '
+            << bike.getWheelSize() << ' ' << bike.getGearCount() << ' ' << bike.getPrice();
+        if (auto mountain = dynamic_cast<const MountainBike *>(&bike)) {
+            out << ' ' << mountain->getSuspensionModel() << ' ' << static_cast<int>(mountain->getSuspensionType());
+        } else if (auto road = dynamic_cast<const RoadBike *>(&bike)) {
+            out << ' ' << static_cast<int>(road->getAerodynamics());
+        }
+    }
+
+    // Наступне замовлення: 1-4 позиції популярних моделей; тип і знижка - випадкові
+    unique_ptr<Order> makeOrder(float &discount) {
+        string user = "customer" + to_string(customerPopularity(rng));
+        vector<OrderItem> items;
+        size_t lines = 1 + rng() % 4;
+        for (size_t line = 0; line < lines; ++line) {
+            items.emplace_back(bikes[bikePopularity(rng)], 1 + static_cast<int>(rng() % 3));
+        }
+        discount = 0;
+        switch (rng() % 10) {
+            case 0:
+            case 1:
+            case 2:
+                discount = static_cast<float>(5 * (1 + rng() % 6));
+                return make_unique<FixedDiscountOrder>(user, std::move(items), discount);
+            case 3:
+            case 4:
+                return make_unique<ProgressiveDiscountOrder>(user, std::move(items));
+            default:
+                return make_unique<Order>(user, std::move(items));
+        }
+    }
+
+    void writeOrder(ReportWriter &out, const Order &order, float discount) const {
+        out << static_cast<int>(order.getType()) << ' ';
+        if (config.format >= 2) out << order.getSoldAt() << ' ';
+        out << order.getUser() << ' ' << order.getItems().size() << ' ';
+        for (const auto &item: order.getItems()) {
+            writeBike(out, *item.getBike());
+            out << ' ' << item.getQuantity() << ' ';
+        }
+        if (order.getType() == OrderType::FixedDiscount) out << static_cast<double>(discount);
+        out << ' ';
+    }
+
+public:
+    explicit DatasetGenerator(const GeneratorConfig &config)
+            : config(config), rng(config.seed),
+              bikePopularity(config.bikes, config.zipf, rng),
+              customerPopularity(config.customers, config.zipf, rng),
+              clock(config.start) {
+        for (size_t i = 0; i < config.bikes; ++i) {
+            bikes.push_back(makeBike(to_string(i)));
+        }
+        stock.assign(config.bikes, 0);
+    }
+
+    void writeDataset() {
+        FILE *file = fopen(config.out.c_str(), "wb");
+        if (!file) throw runtime_error("Failed to open file for writing.");
+        FileSink sink(file);
+        {
+            ReportWriter out(sink);
+            if (config.format >= 2) out << 'V' << config.format << '\n';
+            out << bikes.size() << '\n';
+            // Запас з розрахунку на популярність: частіше замовлювані моделі мають більше на складі
+            for (size_t i = 0; i < bikes.size(); ++i) {
+                stock[i] = 5 + static_cast<long long>(rng() % 50);
+            }
+            for (size_t i = 0; i < config.orders / 2 && !bikes.empty(); ++i) {
+                stock[bikePopularity(rng)] += 3;
+            }
+            for (size_t i = 0; i < bikes.size(); ++i) {
+                writeBike(out, *bikes[i]);
+                out << ' ' << stock[i] << ' ';
+            }
+            out << '\n';
+            out.flush();
+        }
+
+        // Підсумки потрібні до замовлень, тож замовлення генеруються двічі з тим самим зерном
+        auto orderSeed = rng();
+        double revenue = 0;
+        long long sold = 0;
+        rng.seed(orderSeed);
+        for (size_t i = 0; i < config.orders; ++i) {
+            float discount;
+            auto order = makeOrder(discount);
+            revenue += order->calculateTotalPrice();
+            sold += order->getTotalItems();
+        }
+
+        StreamingSketches sketches;
+        ReportWriter out(sink);
+        out << revenue << '\n' << sold << '\n' << config.orders << '\n';
+        rng.seed(orderSeed);
+        mt19937_64 arrivals(orderSeed ^ 0x9e3779b97f4a7c15ULL); // Окремий генератор, щоб не зсунути замовлення
+        for (size_t i = 0; i < config.orders; ++i) {
+            float discount;
+            auto order = makeOrder(discount);
+            clock += 1 + static_cast<long long>(arrivals() % 120);
+            order->setSoldAt(clock);
+            writeOrder(out, *order, discount);
+            if (config.format >= 3) sketches.record(*order);
+        }
+        out << '\n';
+        out.flush();
+        if (config.format >= 3) {
+            ostringstream section;
+            sketches.write(section);
+            sink.write(section.str());
+        }
+        if (fclose(file) != 0) throw runtime_error("Failed to write dataset file.");
+    }
+
+    // Траса: відправки (здебільшого), поповнення, пошуки, нові і видалені моделі, збереження
+    // Запас відстежується, тож відправки у трасі здебільшого виконуються успішно
+    void writeTrace() {
+        FILE *file = fopen(config.trace.c_str(), "wb");
+        if (!file) throw runtime_error("Failed to open file for writing.");
+        {
+            FileSink sink(file);
+            ReportWriter out(sink);
+            out << "# indiv-oop trace 1\n";
+            vector<string> added;
+            size_t nextModel = bikes.size();
+            for (size_t op = 0; op < config.traceOps; ++op) {
+                auto roll = rng() % 1000;
+                if (roll < 700) {
+                    float discount;
+                    auto order = makeOrder(discount);
+                    for (const auto &item: order->getItems()) {
+                        size_t index = indexOf(*item.getBike());
+                        if (stock[index] < item.getQuantity()) {
+                            out << "restock " << item.getBike()->getModel() << ' ' << 50 << '\n';
+                            stock[index] += 50;
+                        }
+                        stock[index] -= item.getQuantity();
+                    }
+                    out << "ship " << static_cast<int>(order->getType()) << ' '
+                        << (order->getType() == OrderType::FixedDiscount ? static_cast<double>(discount) : 0.0) << ' '
+                        << order->getUser() << ' ' << order->getItems().size();
+                    for (const auto &item: order->getItems()) {
+                        out << ' ' << item.getBike()->getModel() << ' ' << item.getQuantity();
+                    }
+                    out << '\n';
+                } else if (roll < 850) {
+                    out << "find " << bikes[bikePopularity(rng)]->getModel() << '\n';
+                } else if (roll < 950) {
+                    size_t index = bikePopularity(rng);
+                    int quantity = 1 + static_cast<int>(rng() % 20);
+                    stock[index] += quantity;
+                    out << "restock " << bikes[index]->getModel() << ' ' << quantity << '\n';
+                } else if (roll < 980 || added.empty()) {
+                    auto bike = makeBike("N" + to_string(nextModel++));
+                    out << "add ";
+                    writeBike(out, *bike);
+                    out << ' ' << 1 + rng() % 20 << '\n';
+                    added.push_back(bike->getModel());
+                } else if (roll < 999) {
+                    out << "remove " << added.back() << '\n';
+                    added.pop_back();
+                } else {
+                    out << "save\n";
+                }
+            }
+            out.flush();
+        }
+        if (fclose(file) != 0) throw runtime_error("Failed to write trace file.");
+    }
+};
+
+int main(int argc, char **argv) {
+    GeneratorConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            auto pos = arg.find('=');
+            if (arg.rfind("--", 0) != 0 || pos == string::npos) throw invalid_argument("Unknown argument: " + arg);
+            string key = arg.substr(2, pos - 2), value = arg.substr(pos + 1);
+            if (key == "out") config.out = value;
+            else if (key == "bikes") config.bikes = static_cast<size_t>(stod(value));
+            else if (key == "orders") config.orders = static_cast<size_t>(stod(value));
+            else if (key == "customers") config.customers = static_cast<size_t>(stod(value));
+            else if (key == "zipf") config.zipf = stod(value);
+            else if (key == "format") config.format = stoi(value);
+            else if (key == "seed") config.seed = stoull(value);
+            else if (key == "start") config.start = stoll(value);
+            else if (key == "trace") config.trace = value;
+            else if (key == "trace-ops") config.traceOps = static_cast<size_t>(stod(value));
+            else throw invalid_argument("Unknown argument: " + arg);
+        }
+        if (config.out.empty() && config.trace.empty()) throw invalid_argument("Nothing to generate: use --out or --trace.");
+        if (config.format < 1 || config.format > 3) throw invalid_argument("Format version must be 1, 2 or 3.");
+        if (config.bikes == 0 || config.customers == 0) throw invalid_argument("Bike and customer counts must be positive.");
+
+        DatasetGenerator generator(config);
+        if (!config.out.empty()) generator.writeDataset();
+        if (!config.trace.empty()) generator.writeTrace();
+    } catch (exception &e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}